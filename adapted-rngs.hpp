@@ -0,0 +1,54 @@
+#ifndef ADAPTED_RNGS_HPP_INCLUDED
+#define ADAPTED_RNGS_HPP_INCLUDED
+
+/*
+ * Width-adapted generators for the benchmarks (see adapters.hpp), named
+ * so they can be used as RNG_TYPE in schemes-split-32.dat and
+ * schemes-combined-64.dat.
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2018 Melissa E. O'Neill
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <random>
+#include "pcg_random.hpp"
+#include "adapters.hpp"
+
+// 64-bit generators split into 32-bit outputs
+using pcg64_split32 = split32<pcg64>;
+using pcg64_fast_split32 = split32<pcg64_fast>;
+using mt19937_64_split32 = split32<std::mt19937_64>;
+
+// 32-bit generators combined into 64-bit outputs
+using pcg32_combine64 = combine64<pcg32>;
+using pcg32_fast_combine64 = combine64<pcg32_fast>;
+using mt19937_combine64 = combine64<std::mt19937>;
+
+// The xoshiro family, if download-gists.sh has fetched it
+#if __has_include("xoshiro.hpp")
+    #include "xoshiro.hpp"
+
+    using xoshiro256plus_split32 = split32<xoshiro256plus64>;
+    using xoshiro128plus_combine64 = combine64<xoshiro128plus32>;
+#endif
+
+#endif // ADAPTED_RNGS_HPP_INCLUDED
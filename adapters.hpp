@@ -0,0 +1,105 @@
+#ifndef ADAPTERS_HPP_INCLUDED
+#define ADAPTERS_HPP_INCLUDED
+
+/*
+ * A C++ implementation of generator width adapters: 32-bit outputs from a
+ * 64-bit generator, and 64-bit outputs from a 32-bit generator.
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2018 Melissa E. O'Neill
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <cstdint>
+#include "bounded.hpp"
+
+/*
+ * split32 turns each output of a 64-bit generator into two 32-bit outputs,
+ * high half first, keeping the spare low half for the next call.  So two
+ * 32-bit draws (e.g., two Lemire multiplies for bounded32) cost one call
+ * of the underlying generator.
+ *
+ * combine64 makes 64-bit outputs from two outputs of a 32-bit generator.
+ * It also overloads rand32 so that 32-bit draws, and so bounded_rand32,
+ * only take one underlying output.
+ *
+ * Both construct the underlying generator from a seed, as the benchmarks
+ * construct rng_t, so they can stand in for it.
+ */
+
+template <typename Rng64>
+class split32 {
+    static_assert(rng_is_64bit<Rng64>(), "split32 needs a 64-bit generator");
+
+    Rng64 rng_;
+    uint32_t spare_ = 0;
+    bool have_spare_ = false;
+
+public:
+    using result_type = uint32_t;
+
+    explicit split32(uint64_t seed = 0) : rng_(seed) {}
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return UINT32_MAX; }
+
+    result_type operator()() {
+	if (have_spare_) {
+	    have_spare_ = false;
+	    return spare_;
+	}
+	uint64_t x = rng_();
+	spare_ = uint32_t(x);
+	have_spare_ = true;
+	return uint32_t(x >> 32);
+    }
+};
+
+template <typename Rng32>
+class combine64 {
+    static_assert(rng_is_32bit<Rng32>(), "combine64 needs a 32-bit generator");
+
+    Rng32 rng_;
+
+public:
+    using result_type = uint64_t;
+
+    explicit combine64(uint64_t seed = 0) : rng_(seed) {}
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return UINT64_MAX; }
+
+    result_type operator()() {
+	return rand64(rng_);
+    }
+
+    // A single output of the underlying generator.
+    uint32_t narrow() {
+	return rand32(rng_);
+    }
+};
+
+template <typename Rng32>
+inline uint32_t rand32(combine64<Rng32>& rng) {
+    return rng.narrow();
+}
+
+#endif // ADAPTERS_HPP_INCLUDED
@@ -0,0 +1,156 @@
+#ifndef BOUNDED_HPP_INCLUDED
+#define BOUNDED_HPP_INCLUDED
+
+/*
+ * A C++ implementation of width-generic bounded random number helpers,
+ * for use by the shuffling and sampling code.
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2018 Melissa E. O'Neill
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <cstdint>
+
+/*
+ * bounded32.cpp and bounded64.cpp pick one method at compile time and
+ * assume the generator matches their width.  The code built on top of them
+ * (shuffles, samplers, etc.) needs to work with any generator from
+ * schemes-32.dat or schemes-64.dat, so these helpers adapt the output width
+ * and then use the debiased integer multiplication method
+ * (USE_DEBIASED_INT_MULT_TOPT).
+ */
+
+// Width is judged by max() rather than result_type, because std::mt19937's
+// result_type is 64 bits wide on some platforms.
+
+template <typename RngT>
+constexpr bool rng_is_32bit() {
+    return RngT::min() == 0 && uint64_t(RngT::max()) == UINT32_MAX;
+}
+
+template <typename RngT>
+constexpr bool rng_is_64bit() {
+    return RngT::min() == 0 && uint64_t(RngT::max()) == UINT64_MAX;
+}
+
+template <typename RngT>
+inline uint32_t rand32(RngT& rng) {
+    static_assert(rng_is_32bit<RngT>() || rng_is_64bit<RngT>(),
+		  "generator must produce full 32- or 64-bit outputs");
+    if constexpr (rng_is_64bit<RngT>())
+	return uint32_t(rng() >> 32);
+    else
+	return rng();
+}
+
+template <typename RngT>
+inline uint64_t rand64(RngT& rng) {
+    static_assert(rng_is_32bit<RngT>() || rng_is_64bit<RngT>(),
+		  "generator must produce full 32- or 64-bit outputs");
+    if constexpr (rng_is_64bit<RngT>()) {
+	return rng();
+    } else {
+	uint64_t hi = rng();
+	return (hi << 32) | uint32_t(rng());
+    }
+}
+
+template <typename RngT>
+inline uint32_t bounded_rand32(RngT& rng, uint32_t range) {
+    uint32_t x = rand32(rng);
+    uint64_t m = uint64_t(x) * uint64_t(range);
+    uint32_t l = uint32_t(m);
+    if (l < range) {
+	uint32_t t = (-range) % range;
+	while (l < t) {
+	    x = rand32(rng);
+	    m = uint64_t(x) * uint64_t(range);
+	    l = uint32_t(m);
+	}
+    }
+    return m >> 32;
+}
+
+template <typename RngT>
+inline uint64_t bounded_rand64(RngT& rng, uint64_t range) {
+    uint64_t x = rand64(rng);
+    __uint128_t m = __uint128_t(x) * __uint128_t(range);
+    uint64_t l = uint64_t(m);
+    if (l < range) {
+	uint64_t t = (-range) % range;
+	while (l < t) {
+	    x = rand64(rng);
+	    m = __uint128_t(x) * __uint128_t(range);
+	    l = uint64_t(m);
+	}
+    }
+    return m >> 64;
+}
+
+// Any 64-bit range, using a single output of a 32-bit generator if the
+// range is small enough.
+
+template <typename RngT>
+inline uint64_t bounded_rand_any(RngT& rng, uint64_t range) {
+    if (!rng_is_64bit<RngT>() && range <= UINT32_MAX)
+	return bounded_rand32(rng, uint32_t(range));
+    return bounded_rand64(rng, range);
+}
+
+/*
+ * A double uniformly distributed in the open interval (0,1), for code that
+ * takes logarithms of it; 53 random bits, offset by half an ulp.
+ */
+
+template <typename RngT>
+inline double uniform01_open(RngT& rng) {
+    return (double(rand64(rng) >> 11) + 0.5) * 0x1.0p-53;
+}
+
+/*
+ * Wraps a generator and counts how many outputs were drawn from it, for
+ * benchmarks that report RNG calls as well as time.
+ */
+
+template <typename RngT>
+struct counting_rng {
+    using result_type = typename RngT::result_type;
+
+    RngT& rng_;
+    uint64_t calls_ = 0;
+
+    counting_rng(RngT& rng) : rng_(rng) {}
+
+    static constexpr result_type min() { return RngT::min(); }
+    static constexpr result_type max() { return RngT::max(); }
+
+    result_type operator()() {
+	++calls_;
+	return rng_();
+    }
+
+    uint64_t calls() const {
+	return calls_;
+    }
+};
+
+#endif // BOUNDED_HPP_INCLUDED
@@ -29,9 +29,15 @@
 #include <cstdint>
 #include <cassert>
 #include <cmath>
+#include <chrono>
 #include <random>
+#include <string>
+#include <cstring>
+#include <stdexcept>
 #include "pcg_random.hpp"
 #include "timer.hpp"
+#include "trace.hpp"
+#include "pressure.hpp"
 
 #ifdef RNG_INCLUDE
     #include RNG_INCLUDE
@@ -367,8 +373,119 @@ static uint32_t bounded_rand(rng_t& rng, uint32_t range) {
     }
 }
 
+#elif USE_OPENJDK
+
+// OpenJDK's RandomGenerator.nextInt(bound) (java.util.random): a mask for
+// powers of two, otherwise modulo with one division and a rejection test on
+// overflow.  Java bounds are signed, so it shifts out one bit of the
+// output first; our ranges are unsigned, so we keep the whole word.
+
+static uint32_t bounded_rand(rng_t& rng, uint32_t range) {
+    uint32_t m = range - 1;
+    uint32_t x = rng();
+    if ((range & m) == 0)
+	return x & m;
+    uint32_t r = x % range;
+    while (x - r > uint32_t(-range)) {
+	x = rng();
+	r = x % range;
+    }
+    return r;
+}
+
+#elif USE_GO_RAND_V2
+
+// Go's math/rand/v2 Uint32N: a mask for powers of two, otherwise integer
+// multiplication of a 64-bit random number by the range, which makes the
+// rejection test (on the low 64 bits of the product) almost never fire.
+
+static uint32_t bounded_rand(rng_t& rng, uint32_t range) {
+    if ((range & (range - 1)) == 0)
+	return rng() & (range - 1);
+    uint64_t hi = rng();
+    uint64_t x = (hi << 32) | rng();
+    __uint128_t m = __uint128_t(x) * __uint128_t(range);
+    uint64_t l = uint64_t(m);
+    if (l < range) {
+	uint64_t t = (-uint64_t(range)) % range;
+	while (l < t) {
+	    hi = rng();
+	    x = (hi << 32) | rng();
+	    m = __uint128_t(x) * __uint128_t(range);
+	    l = uint64_t(m);
+	}
+    }
+    return m >> 64;
+}
+
+#elif USE_RUST_RAND
+
+// Rust rand's sample_single: integer multiplication, accepting if the low
+// half is within a "zone" that is a multiple of the range.  Rather than
+// divide to find the largest such zone, it uses the range shifted up to
+// the top bit, which rejects more often but needs no division.
+
+static uint32_t bounded_rand(rng_t& rng, uint32_t range) {
+    uint32_t zone = (range << __builtin_clz(range)) - 1;
+    uint64_t m;
+    do {
+	uint32_t x = rng();
+	m = uint64_t(x) * uint64_t(range);
+    } while (uint32_t(m) > zone);
+    return m >> 32;
+}
+
+#elif USE_DOTNET
+
+// .NET's System.Random (since .NET 6): take as many high bits as the range
+// needs and retry until the result is in range.
+
+static uint32_t bounded_rand(rng_t& rng, uint32_t range) {
+    if (range <= 1)
+	return 0;
+    unsigned int shift = __builtin_clz(range - 1);
+    uint32_t x;
+    do {
+	x = rng() >> shift;
+    } while (x >= range);
+    return x;
+}
+
 #endif
 
+/*
+ * Replay a trace of recorded ranges (see trace.hpp and gen-ranges.cpp),
+ * repeating it until at least REPLAY_MIN_DRAWS values have been drawn.
+ */
+
+#ifndef REPLAY_MIN_DRAWS
+    #define REPLAY_MIN_DRAWS (1ull << 30)
+#endif
+
+static void replay(rng_t& rng, Timer& timer, const char* path) {
+    mapped_trace<uint32_t> trace(path);
+
+    // Checking the ranges also faults in the pages before we start timing.
+    for (uint32_t range : trace)
+	if (range == 0)
+	    throw std::runtime_error(std::string(path) + ": zero range");
+
+    const char* name = strrchr(path, '/');
+    std::string what = std::string("Replay ") + (name ? name + 1 : path);
+    uint64_t passes = (REPLAY_MIN_DRAWS + trace.size() - 1) / trace.size();
+    uint64_t sum = 0;
+    timer.start(what.c_str());
+    for (uint64_t pass = 0; pass < passes; ++pass) {
+	for (uint32_t range : trace) {
+	    uint32_t bval = bounded_rand(rng, range);
+	    assert(bval < range);
+	    sum += bval;
+	}
+    }
+    timer.done(passes * trace.size());
+    std::cout << what << " sum = " << sum << "\n";
+}
+
 int main(int argc, char* argv[])
 {
     uint64_t sum = 0;
@@ -387,6 +504,20 @@ int main(int argc, char* argv[])
 #endif
     Timer timer;
 
+    // Optionally evict the caches as we go (see pressure.hpp)
+    cache_pressure pressure;
+    if (pressure.active()) {
+	std::cout << "Cache pressure: " << pressure.description() << "\n";
+	timer.exclude(cache_pressure::sweep_seconds);
+    }
+
+    // Given trace files, replay those instead of running the tests below.
+    if (argc > 2) {
+	for (int i = 2; i < argc; ++i)
+	    replay(rng, timer, argv[i]);
+	return 0;
+    }
+
     // Large shuffle
     timer.start("Test 1");
     for (uint32_t i = 0xffffffff; i > 0; --i) {
@@ -394,7 +525,7 @@ int main(int argc, char* argv[])
 	assert(bval < i);
 	sum += bval;
     }
-    timer.done();
+    timer.done(0xffffffff);
     std::cout << "Sum1 = " << sum << "\n";
 
     // Small shuffle
@@ -407,22 +538,49 @@ int main(int argc, char* argv[])
 	    sum += bval;
 	}
     }
-    timer.done();
+    timer.done(uint64_t(0xffff) * 0xffff);
     std::cout << "Sum2 = " << sum << "\n";
     
-    // All-ranges shuffle
+    // All-ranges shuffle, also timed separately for each bit width
     sum = 0;
+    double bucket_seconds[32];
+#if RNG_HAS_DISTANCE
+    decltype(rng - rng) bucket_calls[32];
+#endif
     timer.start("Test 3");
-    for (uint32_t bit = 1; bit != 0; bit <<= 1) {
+    for (uint32_t bit = 1, bucket = 0; bit != 0; bit <<= 1, ++bucket) {
+#if RNG_HAS_DISTANCE
+	rng_t bucket_rng = rng;
+#endif
+	// As Timer does, leave out any time spent in cache_pressure sweeps.
+	double bucket_swept = cache_pressure::sweep_seconds();
+	auto bucket_start = std::chrono::system_clock::now();
 	for (uint32_t i = 0; i < 0x1000000; ++i) {
 	    uint32_t bound = bit | (i & (bit - 1));
 	    uint32_t bval = bounded_rand(rng, bound);
 	    assert(bval < bound);
 	    sum += bval;
 	}
+	std::chrono::duration<double> elapsed =
+	    std::chrono::system_clock::now() - bucket_start;
+	bucket_seconds[bucket] = elapsed.count()
+	    - (cache_pressure::sweep_seconds() - bucket_swept);
+#if RNG_HAS_DISTANCE
+	bucket_calls[bucket] = rng - bucket_rng;
+#endif
     }
-    timer.done();
+    timer.done(32 * 0x1000000);
     std::cout << "Sum3 = " << sum << "\n";
+    for (unsigned bucket = 0; bucket < 32; ++bucket) {
+	std::cout << "Test 3 bits " << bucket + 1 << ": "
+		  << bucket_seconds[bucket] << " seconds, "
+		  << bucket_seconds[bucket] * 1e9 / 0x1000000 << " ns per call";
+#if RNG_HAS_DISTANCE
+	std::cout << ", " << bucket_calls[bucket] << " numbers used ("
+		  << double(bucket_calls[bucket]) / 0x1000000 << " per call)";
+#endif
+	std::cout << "\n";
+    }
 
     // Small constant
     sum = 0;
@@ -432,7 +590,7 @@ int main(int argc, char* argv[])
 	assert(bval < 52);
 	sum += bval;
     }
-    timer.done();
+    timer.done(0x80000000);
     std::cout << "Sum4 = " << sum << "\n";
 
     // Large constant
@@ -443,9 +601,42 @@ int main(int argc, char* argv[])
 	assert(bval < uint32_t(-52));
 	sum += bval;
     }
-    timer.done();
+    timer.done(0x80000000);
     std::cout << "Sum5 = " << sum << "\n";
 
+    // The tests above choose each range independently of earlier results,
+    // so an out-of-order CPU can overlap successive calls.  In the next two,
+    // each range depends on the previous result (as in a random walk), so
+    // they measure latency rather than throughput.
+
+    // Dependent all-ranges
+    sum = 0;
+    uint32_t prev = 0;
+    timer.start("Test 6");
+    for (uint32_t bit = 1; bit != 0; bit <<= 1) {
+	for (uint32_t i = 0; i < 0x1000000; ++i) {
+	    uint32_t bound = bit | (prev & (bit - 1));
+	    prev = bounded_rand(rng, bound);
+	    assert(prev < bound);
+	    sum += prev;
+	}
+    }
+    timer.done(32 * 0x1000000);
+    std::cout << "Sum6 = " << sum << "\n";
+
+    // Dependent small ranges
+    sum = 0;
+    prev = 0;
+    timer.start("Test 7");
+    for (uint32_t i = 0; i < 0x80000000; ++i) {
+	uint32_t bound = 48 + (prev & 7);
+	prev = bounded_rand(rng, bound);
+	assert(prev < bound);
+	sum += prev;
+    }
+    timer.done(0x80000000);
+    std::cout << "Sum7 = " << sum << "\n";
+
 #if RNG_HAS_DISTANCE
     std::cout << rng - rng_copy << " numbers used" << "\n";
 #endif
@@ -29,9 +29,16 @@
 #include <cstdint>
 #include <cassert>
 #include <cmath>
+#include <chrono>
 #include <random>
+#include <string>
+#include <cstring>
+#include <stdexcept>
 #include "pcg_random.hpp"
 #include "timer.hpp"
+#include "trace.hpp"
+#include "pressure.hpp"
+#include "adapters.hpp"
 
 #ifdef RNG_INCLUDE
     #include RNG_INCLUDE
@@ -266,6 +273,30 @@ static uint64_t bounded_rand(rng_t& rng, uint64_t range) {
     return m >> 64;
 }
 
+#elif USE_DEBIASED_INT_MULT_NARROW
+
+// As USE_DEBIASED_INT_MULT_TOPT, but a range that fits in 32 bits takes a
+// 32-bit draw and multiply (bounded_rand32, from bounded.hpp).  That is
+// still one output of a native 64-bit generator, but only half an output
+// of a combine64 adapter (see adapters.hpp).
+
+static uint64_t bounded_rand(rng_t& rng, uint64_t range) {
+    if (range <= UINT32_MAX)
+	return bounded_rand32(rng, uint32_t(range));
+    uint64_t x = rng();
+    __uint128_t m = __uint128_t(x) * __uint128_t(range);
+    uint64_t l = uint64_t(m);
+    if (l < range) {
+	uint64_t t = (-range) % range;
+	while (l < t) {
+	    x = rng();
+	    m = __uint128_t(x) * __uint128_t(range);
+	    l = uint64_t(m);
+	}
+    }
+    return m >> 64;
+}
+
 #elif USE_DEBIASED_INT_MULT_TOPT_BOPT
 
 static uint64_t bounded_rand(rng_t& rng, uint64_t range) {
@@ -370,8 +401,117 @@ static uint64_t bounded_rand(rng_t& rng, uint64_t range) {
     }
 }
 
+#elif USE_OPENJDK
+
+// OpenJDK's RandomGenerator.nextLong(bound) (java.util.random): a mask for
+// powers of two, otherwise modulo with one division and a rejection test on
+// overflow.  Java bounds are signed, so it shifts out one bit of the
+// output first; our ranges are unsigned, so we keep the whole word.
+
+static uint64_t bounded_rand(rng_t& rng, uint64_t range) {
+    uint64_t m = range - 1;
+    uint64_t x = rng();
+    if ((range & m) == 0)
+	return x & m;
+    uint64_t r = x % range;
+    while (x - r > uint64_t(-range)) {
+	x = rng();
+	r = x % range;
+    }
+    return r;
+}
+
+#elif USE_GO_RAND_V2
+
+// Go's math/rand/v2 Uint64N: a mask for powers of two, otherwise debiased
+// integer multiplication (as USE_DEBIASED_INT_MULT_TOPT), using a full
+// 128-bit product.
+
+static uint64_t bounded_rand(rng_t& rng, uint64_t range) {
+    if ((range & (range - 1)) == 0)
+	return rng() & (range - 1);
+    uint64_t x = rng();
+    __uint128_t m = __uint128_t(x) * __uint128_t(range);
+    uint64_t l = uint64_t(m);
+    if (l < range) {
+	uint64_t t = (-range) % range;
+	while (l < t) {
+	    x = rng();
+	    m = __uint128_t(x) * __uint128_t(range);
+	    l = uint64_t(m);
+	}
+    }
+    return m >> 64;
+}
+
+#elif USE_RUST_RAND
+
+// Rust rand's sample_single: integer multiplication, accepting if the low
+// half is within a "zone" that is a multiple of the range.  Rather than
+// divide to find the largest such zone, it uses the range shifted up to
+// the top bit, which rejects more often but needs no division.
+
+static uint64_t bounded_rand(rng_t& rng, uint64_t range) {
+    uint64_t zone = (range << __builtin_clzll(range)) - 1;
+    __uint128_t m;
+    do {
+	uint64_t x = rng();
+	m = __uint128_t(x) * __uint128_t(range);
+    } while (uint64_t(m) > zone);
+    return m >> 64;
+}
+
+#elif USE_DOTNET
+
+// .NET's System.Random (since .NET 6): take as many high bits as the range
+// needs and retry until the result is in range.
+
+static uint64_t bounded_rand(rng_t& rng, uint64_t range) {
+    if (range <= 1)
+	return 0;
+    unsigned int shift = __builtin_clzll(range - 1);
+    uint64_t x;
+    do {
+	x = rng() >> shift;
+    } while (x >= range);
+    return x;
+}
+
 #endif
 
+/*
+ * Replay a trace of recorded ranges (see trace.hpp and gen-ranges.cpp),
+ * repeating it until at least REPLAY_MIN_DRAWS values have been drawn.
+ */
+
+#ifndef REPLAY_MIN_DRAWS
+    #define REPLAY_MIN_DRAWS (1ull << 30)
+#endif
+
+static void replay(rng_t& rng, Timer& timer, const char* path) {
+    mapped_trace<uint64_t> trace(path);
+
+    // Checking the ranges also faults in the pages before we start timing.
+    for (uint64_t range : trace)
+	if (range == 0)
+	    throw std::runtime_error(std::string(path) + ": zero range");
+
+    const char* name = strrchr(path, '/');
+    std::string what = std::string("Replay ") + (name ? name + 1 : path);
+    uint64_t passes = (REPLAY_MIN_DRAWS + trace.size() - 1) / trace.size();
+    uint64_t sum = 0;
+    timer.start(what.c_str());
+    for (uint64_t pass = 0; pass < passes; ++pass) {
+	for (uint64_t range : trace) {
+	    uint64_t bval = bounded_rand(rng, range);
+	    assert(bval < range);
+	    sum += bval;
+	}
+    }
+    timer.done(passes * trace.size());
+    std::cout << what << " sum = " << sum << "\n";
+}
+
 int main(int argc, char* argv[])
 {
     pcg_extras::pcg128_t sum = 0;
@@ -392,6 +532,20 @@ int main(int argc, char* argv[])
 #endif
     Timer timer;
 
+    // Optionally evict the caches as we go (see pressure.hpp)
+    cache_pressure pressure;
+    if (pressure.active()) {
+	std::cout << "Cache pressure: " << pressure.description() << "\n";
+	timer.exclude(cache_pressure::sweep_seconds);
+    }
+
+    // Given trace files, replay those instead of running the tests below.
+    if (argc > 2) {
+	for (int i = 2; i < argc; ++i)
+	    replay(rng, timer, argv[i]);
+	return 0;
+    }
+
     // Large shuffle
     timer.start("Test 1");
     for (uint32_t i = 0xffffffff; i > 0; --i) {
@@ -400,7 +554,7 @@ int main(int argc, char* argv[])
 	assert(bval < bound);
 	sum += bval;
     }
-    timer.done();
+    timer.done(0xffffffff);
     std::cout << "Sum1 = " << sum << "\n";
 
     // Small shuffle
@@ -411,22 +565,49 @@ int main(int argc, char* argv[])
 	assert(bval < i);
 	sum += bval;
     }
-    timer.done();
+    timer.done(0xffffffff);
     std::cout << "Sum2 = " << sum << "\n";
 
-    // All-ranges shuffle
+    // All-ranges shuffle, also timed separately for each bit width
     sum = 0;
+    double bucket_seconds[64];
+#if RNG_HAS_DISTANCE
+    decltype(rng - rng) bucket_calls[64];
+#endif
     timer.start("Test 3");
-    for (uint64_t bit = 1; bit != 0; bit <<= 1) {
+    for (uint64_t bit = 1, bucket = 0; bit != 0; bit <<= 1, ++bucket) {
+#if RNG_HAS_DISTANCE
+	rng_t bucket_rng = rng;
+#endif
+	// As Timer does, leave out any time spent in cache_pressure sweeps.
+	double bucket_swept = cache_pressure::sweep_seconds();
+	auto bucket_start = std::chrono::system_clock::now();
 	for (uint32_t i = 0; i < 0x800000; ++i) {
 	    uint64_t bound = bit | (i & (bit - 1));
 	    uint64_t bval = bounded_rand(rng, bound);
 	    assert(bval < bound);
 	    sum += bval;
 	}
+	std::chrono::duration<double> elapsed =
+	    std::chrono::system_clock::now() - bucket_start;
+	bucket_seconds[bucket] = elapsed.count()
+	    - (cache_pressure::sweep_seconds() - bucket_swept);
+#if RNG_HAS_DISTANCE
+	bucket_calls[bucket] = rng - bucket_rng;
+#endif
     }
-    timer.done();
+    timer.done(64 * 0x800000);
     std::cout << "Sum3 = " << sum << "\n";
+    for (unsigned bucket = 0; bucket < 64; ++bucket) {
+	std::cout << "Test 3 bits " << bucket + 1 << ": "
+		  << bucket_seconds[bucket] << " seconds, "
+		  << bucket_seconds[bucket] * 1e9 / 0x800000 << " ns per call";
+#if RNG_HAS_DISTANCE
+	std::cout << ", " << bucket_calls[bucket] << " numbers used ("
+		  << double(bucket_calls[bucket]) / 0x800000 << " per call)";
+#endif
+	std::cout << "\n";
+    }
 
     // Small constant
     sum = 0;
@@ -436,7 +617,7 @@ int main(int argc, char* argv[])
 	assert(bval < 52);
 	sum += bval;
     }
-    timer.done();
+    timer.done(0x80000000);
     std::cout << "Sum4 = " << sum << "\n";
 
     // Large constant
@@ -447,9 +628,42 @@ int main(int argc, char* argv[])
 	assert(bval < uint64_t(-52));
 	sum += bval;
     }
-    timer.done();
+    timer.done(0x80000000);
     std::cout << "Sum4 = " << sum << "\n";
 
+    // The tests above choose each range independently of earlier results,
+    // so an out-of-order CPU can overlap successive calls.  In the next two,
+    // each range depends on the previous result (as in a random walk), so
+    // they measure latency rather than throughput.
+
+    // Dependent all-ranges
+    sum = 0;
+    uint64_t prev = 0;
+    timer.start("Test 6");
+    for (uint64_t bit = 1; bit != 0; bit <<= 1) {
+	for (uint32_t i = 0; i < 0x800000; ++i) {
+	    uint64_t bound = bit | (prev & (bit - 1));
+	    prev = bounded_rand(rng, bound);
+	    assert(prev < bound);
+	    sum += prev;
+	}
+    }
+    timer.done(64 * 0x800000);
+    std::cout << "Sum6 = " << sum << "\n";
+
+    // Dependent small ranges
+    sum = 0;
+    prev = 0;
+    timer.start("Test 7");
+    for (uint32_t i = 0; i < 0x80000000; ++i) {
+	uint64_t bound = 48 + (prev & 7);
+	prev = bounded_rand(rng, bound);
+	assert(prev < bound);
+	sum += prev;
+    }
+    timer.done(0x80000000);
+    std::cout << "Sum7 = " << sum << "\n";
+
 #if RNG_HAS_DISTANCE
     std::cout << rng - rng_copy << " numbers used" << "\n";
 #endif
@@ -0,0 +1,148 @@
+/*
+ * A C++ benchmark for coin flips and Bernoulli trials
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2018 Melissa E. O'Neill
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <iostream>
+#include <cstdint>
+#include <cstdlib>
+#include <random>
+#include "pcg_random.hpp"
+#include "timer.hpp"
+#include "coinflip.hpp"
+
+#ifdef RNG_INCLUDE
+    #include RNG_INCLUDE
+#endif
+
+#ifndef RNG_TYPE
+    #define RNG_TYPE std::mt19937
+#endif
+
+using base_rng_t = RNG_TYPE;
+using rng_t = counting_rng<base_rng_t>;
+
+/*
+ * Each variant counts heads in nwords * 64 Bernoulli(a/b) trials; the
+ * flips are made one at a time except in the BULK variant.
+ */
+
+#if USE_BOUNDED_RAND
+
+static uint64_t heads(rng_t& rng, size_t nwords, uint64_t a, uint64_t b) {
+    uint64_t count = 0;
+    if (rng_is_32bit<rng_t>() && b <= UINT32_MAX) {
+	for (size_t i = 0; i < nwords * 64; ++i)
+	    count += bounded_rand32(rng, uint32_t(b)) < a;
+    } else {
+	for (size_t i = 0; i < nwords * 64; ++i)
+	    count += bounded_rand64(rng, b) < a;
+    }
+    return count;
+}
+
+#elif USE_COIN_FLIPPER
+
+static uint64_t heads(rng_t& rng, size_t nwords, uint64_t a, uint64_t b) {
+    coin_flipper<rng_t> coin(rng);
+    uint64_t count = 0;
+    if (a * 2 == b) {
+	for (size_t i = 0; i < nwords * 64; ++i)
+	    count += coin.fair();
+    } else {
+	bernoulli_param p(a, b);
+	for (size_t i = 0; i < nwords * 64; ++i)
+	    count += coin.bernoulli(p);
+    }
+    return count;
+}
+
+#elif USE_COIN_FLIPPER_LAZY
+
+// Digit-at-a-time Bernoulli trials, without precomputing p's digits.
+
+static uint64_t heads(rng_t& rng, size_t nwords, uint64_t a, uint64_t b) {
+    coin_flipper<rng_t> coin(rng);
+    uint64_t count = 0;
+    for (size_t i = 0; i < nwords * 64; ++i)
+	count += coin.bernoulli(a, b);
+    return count;
+}
+
+#elif USE_BULK
+
+static uint64_t heads(rng_t& rng, size_t nwords, uint64_t a, uint64_t b) {
+    constexpr size_t CHUNK = 4096;
+    uint64_t bitmap[CHUNK];
+    uint64_t count = 0;
+    for (size_t i = 0; i < nwords; i += CHUNK) {
+	size_t words = nwords - i < CHUNK ? nwords - i : CHUNK;
+	fill_bernoulli(rng, bitmap, words, a, b);
+	for (size_t j = 0; j < words; ++j)
+	    count += __builtin_popcountll(bitmap[j]);
+    }
+    return count;
+}
+
+#endif
+
+int main(int argc, char* argv[])
+{
+    uint64_t seed;
+    if (argc <= 1) {
+	std::random_device rdev;
+	seed = rdev();
+	seed <<= 32;
+	seed |= rdev();
+    } else {
+	seed = strtoul(argv[1], nullptr, 0);
+    }
+    base_rng_t base_rng(seed);
+    rng_t rng(base_rng);
+    Timer timer;
+
+    struct {
+	const char* what;
+	uint64_t a, b;
+    } tests[] = {
+	{ "Test 1", 1, 2 },			// Fair coin
+	{ "Test 2", 1, 3 },			// Small denominator
+	{ "Test 3", 52, 1000 },			// Rare-ish event
+	{ "Test 4", 0x5555555555, 0xffffffffff }	// Large denominator
+    };
+    constexpr size_t NWORDS = 1 << 24;		// 2^30 flips per test
+
+    for (auto& test : tests) {
+	uint64_t calls_before = rng.calls();
+	timer.start(test.what);
+	uint64_t count = heads(rng, NWORDS, test.a, test.b);
+	timer.done();
+	uint64_t calls = rng.calls() - calls_before;
+	double flips = double(NWORDS) * 64;
+	std::cout << test.what << ": " << count << " heads in " << flips
+		  << " flips of p = " << test.a << "/" << test.b << " ("
+		  << count / flips << "), " << calls / flips
+		  << " RNG calls per flip\n";
+    }
+}
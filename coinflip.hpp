@@ -0,0 +1,187 @@
+#ifndef COINFLIP_HPP_INCLUDED
+#define COINFLIP_HPP_INCLUDED
+
+/*
+ * A C++ implementation of bit-efficient coin flips: fair bits and exact
+ * Bernoulli trials served from a buffered generator output.
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2018 Melissa E. O'Neill
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <cassert>
+#include "bounded.hpp"
+
+/*
+ * bounded_rand(rng, 2) and bounded_rand(rng, b) < a each use up a whole
+ * generator output to make a one-bit decision.  A coin_flipper keeps the
+ * unused bits of the last output and hands them out as needed.
+ *
+ * A Bernoulli(a/b) trial compares a uniform U in [0,1) against p = a/b one
+ * binary digit at a time: we produce the next digit of p by long division
+ * and the next digit of U from the buffer, and stop at the first place
+ * they differ (U < p if U's digit is the 0).  Each digit decides with
+ * probability 1/2, so a trial uses 2 bits on average, whatever b is, and
+ * is exact.
+ *
+ * Doing that a digit at a time means a hard-to-predict branch per digit,
+ * so for repeated trials with the same p, bernoulli_param precomputes the
+ * first 64 digits of p and we compare them against all the buffered bits
+ * at once, finding the first difference with a count-trailing-zeros.
+ */
+
+struct bernoulli_param {
+    uint64_t b;
+    uint64_t digits;	// first 64 binary digits of a/b, first digit in bit 0
+    uint64_t rem;	// long division remainder after those digits
+    bool always;	// p = 1, which has no binary digits to compare
+
+    // p = a/b; needs a <= b <= 2^63.
+    bernoulli_param(uint64_t a, uint64_t b)
+	: b(b), digits(0), rem(a), always(a == b)
+    {
+	assert(a <= b && b <= (uint64_t(1) << 63));
+	if (always)
+	    return;
+	for (unsigned i = 0; i < 64; ++i) {
+	    rem <<= 1;
+	    if (rem >= b) {
+		rem -= b;
+		digits |= uint64_t(1) << i;
+	    }
+	}
+    }
+};
+
+template <typename RngT>
+class coin_flipper {
+    static constexpr unsigned WORD_BITS = rng_is_64bit<RngT>() ? 64 : 32;
+
+    RngT& rng_;
+    uint64_t bits_ = 0;
+    unsigned avail_ = 0;
+
+    void refill() {
+	bits_ = WORD_BITS == 64 ? rand64(rng_) : rand32(rng_);
+	avail_ = WORD_BITS;
+    }
+
+    // Discard 1 <= count <= 64 bits, of which we have at least count.
+    void consume(unsigned count) {
+	bits_ = (bits_ >> (count - 1)) >> 1;
+	avail_ -= count;
+    }
+
+    // Continue a Bernoulli trial once U and p agree up to the remainder r.
+    bool bernoulli_tail(uint64_t r, uint64_t b) {
+	while (r != 0) {
+	    r <<= 1;
+	    bool digit = r >= b;
+	    if (digit)
+		r -= b;
+	    if (fair() != digit)
+		return digit;
+	}
+	return false;
+    }
+
+public:
+    coin_flipper(RngT& rng) : rng_(rng) {}
+
+    bool fair() {
+	if (avail_ == 0)
+	    refill();
+	bool bit = bits_ & 1;
+	consume(1);
+	return bit;
+    }
+
+    // True with probability a/b; needs a <= b <= 2^63.
+    bool bernoulli(uint64_t a, uint64_t b) {
+	assert(a <= b && b <= (uint64_t(1) << 63));
+	if (a == b)
+	    return true;
+	return bernoulli_tail(a, b);
+    }
+
+    bool bernoulli(const bernoulli_param& p) {
+	if (p.always)
+	    return true;
+	uint64_t digits = p.digits;
+	unsigned left = 64;		// precomputed digits not yet compared
+	for (;;) {
+	    if (avail_ == 0)
+		refill();
+	    unsigned count = avail_ < left ? avail_ : left;
+	    uint64_t mask = ~uint64_t(0) >> (64 - count);
+	    uint64_t diff = (bits_ ^ digits) & mask;
+	    if (diff != 0) {
+		unsigned pos = __builtin_ctzll(diff);
+		consume(pos + 1);
+		return (digits >> pos) & 1;
+	    }
+	    consume(count);
+	    digits = (digits >> (count - 1)) >> 1;
+	    left -= count;
+	    if (left == 0)
+		return bernoulli_tail(p.rem, p.b);
+	}
+    }
+};
+
+/*
+ * Fill nwords words of bitmap with independent Bernoulli(a/b) bits.  This
+ * runs the same digit-by-digit comparison for 64 bits at once, using one
+ * generator word per digit, and stops when every bit is decided; that takes
+ * about log2(64) + 2 digits per word for most p, and one for p = 1/2.
+ */
+
+template <typename RngT>
+void fill_bernoulli(RngT& rng, uint64_t* bitmap, size_t nwords,
+		    uint64_t a, uint64_t b) {
+    assert(a <= b && b <= (uint64_t(1) << 63));
+    for (size_t i = 0; i < nwords; ++i) {
+	if (a == b) {
+	    bitmap[i] = ~uint64_t(0);
+	    continue;
+	}
+	uint64_t result = 0;
+	uint64_t undecided = ~uint64_t(0);
+	uint64_t r = a;
+	while (r != 0 && undecided != 0) {
+	    r <<= 1;
+	    uint64_t u = rand64(rng);
+	    if (r >= b) {
+		r -= b;
+		result |= undecided & ~u;
+		undecided &= u;
+	    } else {
+		undecided &= ~u;
+	    }
+	}
+	bitmap[i] = result;
+    }
+}
+
+#endif // COINFLIP_HPP_INCLUDED
@@ -11,30 +11,67 @@ EXECDIR=tests
 
 {
 
-while read -A line
+echo $GPLUSPLUS gen-ranges.cpp -Ipcg-cpp-master/include -o gen-ranges
+
+cat schemes-32.dat schemes-split-32.dat | while read -A line
 do
 foreach method (`perl -ne 'print if s/^#.*if.*USE_//' bounded32.cpp`)
-echo $GPLUSPLUS bounded32.cpp -Ipcg-cpp-master/include -DUSE_$method -DRNG_INCLUDE=$line[1] -DRNG_TYPE=$line[2] $line[3,-1] -o $EXECDIR/bounded32.$line[2].$method.gcc
-echo $CLANGPLUSPLUS bounded32.cpp -Ipcg-cpp-master/include -DUSE_$method -DRNG_INCLUDE=$line[1] -DRNG_TYPE=$line[2] $line[3,-1] -o $EXECDIR/bounded32.$line[2].$method.clang
+echo $GPLUSPLUS bounded32.cpp -pthread -Ipcg-cpp-master/include -DUSE_$method -DRNG_INCLUDE=$line[1] -DRNG_TYPE=$line[2] $line[3,-1] -o $EXECDIR/bounded32.$line[2].$method.gcc
+echo $CLANGPLUSPLUS bounded32.cpp -pthread -Ipcg-cpp-master/include -DUSE_$method -DRNG_INCLUDE=$line[1] -DRNG_TYPE=$line[2] $line[3,-1] -o $EXECDIR/bounded32.$line[2].$method.clang
 end
 foreach method (STD)
-echo $GPLUSPLUS bounded32.cpp -Ipcg-cpp-master/include -DUSE_$method -DRNG_INCLUDE=$line[1] -DRNG_TYPE=$line[2] $line[3,-1] $GPLUSPLUS_USELIBCPP -o $EXECDIR/bounded32.$line[2].$method-libc++.gcc
-echo $CLANGPLUSPLUS -stdlib=libc++ bounded32.cpp -Ipcg-cpp-master/include -DUSE_$method -DRNG_INCLUDE=$line[1] -DRNG_TYPE=$line[2] $line[3,-1] -o $EXECDIR/bounded32.$line[2].$method-libc++.clang
+echo $GPLUSPLUS bounded32.cpp -pthread -Ipcg-cpp-master/include -DUSE_$method -DRNG_INCLUDE=$line[1] -DRNG_TYPE=$line[2] $line[3,-1] $GPLUSPLUS_USELIBCPP -o $EXECDIR/bounded32.$line[2].$method-libc++.gcc
+echo $CLANGPLUSPLUS -stdlib=libc++ bounded32.cpp -pthread -Ipcg-cpp-master/include -DUSE_$method -DRNG_INCLUDE=$line[1] -DRNG_TYPE=$line[2] $line[3,-1] -o $EXECDIR/bounded32.$line[2].$method-libc++.clang
 end
-done < schemes-32.dat
+done
 
-while read -A line
+cat schemes-64.dat schemes-combined-64.dat | while read -A line
 do
 foreach method (`perl -ne 'print if s/^#.*if.*USE_//' bounded64.cpp`)
-echo $GPLUSPLUS bounded64.cpp -Ipcg-cpp-master/include -DUSE_$method -DRNG_INCLUDE=$line[1] -DRNG_TYPE=$line[2] $line[3,-1] -o $EXECDIR/bounded64.$line[2].$method.gcc
-echo $CLANGPLUSPLUS bounded64.cpp -Ipcg-cpp-master/include -DUSE_$method -DRNG_INCLUDE=$line[1] -DRNG_TYPE=$line[2] $line[3,-1] -o $EXECDIR/bounded64.$line[2].$method.clang
+echo $GPLUSPLUS bounded64.cpp -pthread -Ipcg-cpp-master/include -DUSE_$method -DRNG_INCLUDE=$line[1] -DRNG_TYPE=$line[2] $line[3,-1] -o $EXECDIR/bounded64.$line[2].$method.gcc
+echo $CLANGPLUSPLUS bounded64.cpp -pthread -Ipcg-cpp-master/include -DUSE_$method -DRNG_INCLUDE=$line[1] -DRNG_TYPE=$line[2] $line[3,-1] -o $EXECDIR/bounded64.$line[2].$method.clang
 end
 foreach method (STD)
-echo $GPLUSPLUS bounded64.cpp -Ipcg-cpp-master/include -DUSE_$method -DRNG_INCLUDE=$line[1] -DRNG_TYPE=$line[2] $line[3,-1] $GPLUSPLUS_USELIBCPP -o $EXECDIR/bounded64.$line[2].$method-libc++.gcc
-echo $CLANGPLUSPLUS -stdlib=libc++ bounded64.cpp -Ipcg-cpp-master/include -DUSE_$method -DRNG_INCLUDE=$line[1] -DRNG_TYPE=$line[2] $line[3,-1] -o $EXECDIR/bounded64.$line[2].$method-libc++.clang
+echo $GPLUSPLUS bounded64.cpp -pthread -Ipcg-cpp-master/include -DUSE_$method -DRNG_INCLUDE=$line[1] -DRNG_TYPE=$line[2] $line[3,-1] $GPLUSPLUS_USELIBCPP -o $EXECDIR/bounded64.$line[2].$method-libc++.gcc
+echo $CLANGPLUSPLUS -stdlib=libc++ bounded64.cpp -pthread -Ipcg-cpp-master/include -DUSE_$method -DRNG_INCLUDE=$line[1] -DRNG_TYPE=$line[2] $line[3,-1] -o $EXECDIR/bounded64.$line[2].$method-libc++.clang
+end
+done
+
+cat schemes-32.dat schemes-64.dat | while read -A line
+do
+foreach method (`perl -ne 'print if s/^#.*if.*USE_//' shuffle.cpp`)
+foreach elemsize (4 64)
+echo $GPLUSPLUS shuffle.cpp -Ipcg-cpp-master/include -DUSE_$method -DELEM_SIZE=$elemsize -DRNG_INCLUDE=$line[1] -DRNG_TYPE=$line[2] $line[3,-1] -o $EXECDIR/shuffle$elemsize.$line[2].$method.gcc
+echo $CLANGPLUSPLUS shuffle.cpp -Ipcg-cpp-master/include -DUSE_$method -DELEM_SIZE=$elemsize -DRNG_INCLUDE=$line[1] -DRNG_TYPE=$line[2] $line[3,-1] -o $EXECDIR/shuffle$elemsize.$line[2].$method.clang
+end
+end
+foreach method (`perl -ne 'print if s/^#.*if.*USE_//' sample.cpp`)
+echo $GPLUSPLUS sample.cpp -Ipcg-cpp-master/include -DUSE_$method -DRNG_INCLUDE=$line[1] -DRNG_TYPE=$line[2] $line[3,-1] -o $EXECDIR/sample.$line[2].$method.gcc
+echo $CLANGPLUSPLUS sample.cpp -Ipcg-cpp-master/include -DUSE_$method -DRNG_INCLUDE=$line[1] -DRNG_TYPE=$line[2] $line[3,-1] -o $EXECDIR/sample.$line[2].$method.clang
+end
+foreach method (`perl -ne 'print if s/^#.*if.*USE_//' permutation.cpp`)
+echo $GPLUSPLUS permutation.cpp -Ipcg-cpp-master/include -DUSE_$method -DRNG_INCLUDE=$line[1] -DRNG_TYPE=$line[2] $line[3,-1] -o $EXECDIR/permutation.$line[2].$method.gcc
+echo $CLANGPLUSPLUS permutation.cpp -Ipcg-cpp-master/include -DUSE_$method -DRNG_INCLUDE=$line[1] -DRNG_TYPE=$line[2] $line[3,-1] -o $EXECDIR/permutation.$line[2].$method.clang
+end
+foreach method (`perl -ne 'print if s/^#.*if.*USE_//' coinflip.cpp`)
+echo $GPLUSPLUS coinflip.cpp -Ipcg-cpp-master/include -DUSE_$method -DRNG_INCLUDE=$line[1] -DRNG_TYPE=$line[2] $line[3,-1] -o $EXECDIR/coinflip.$line[2].$method.gcc
+echo $CLANGPLUSPLUS coinflip.cpp -Ipcg-cpp-master/include -DUSE_$method -DRNG_INCLUDE=$line[1] -DRNG_TYPE=$line[2] $line[3,-1] -o $EXECDIR/coinflip.$line[2].$method.clang
+end
+foreach method (`perl -ne 'print if s/^#.*if.*USE_//' ring.cpp`)
+echo $GPLUSPLUS ring.cpp -pthread -Ipcg-cpp-master/include -DUSE_$method -DRNG_INCLUDE=$line[1] -DRNG_TYPE=$line[2] $line[3,-1] -lrt -o $EXECDIR/ring.$line[2].$method.gcc
+echo $CLANGPLUSPLUS ring.cpp -pthread -Ipcg-cpp-master/include -DUSE_$method -DRNG_INCLUDE=$line[1] -DRNG_TYPE=$line[2] $line[3,-1] -lrt -o $EXECDIR/ring.$line[2].$method.clang
+end
+done
+
+
+cat schemes-32.dat schemes-64.dat schemes-seekable.dat | while read -A line
+do
+foreach method (`perl -ne 'print if s/^#.*if.*USE_//' stream.cpp`)
+echo $GPLUSPLUS stream.cpp -Ipcg-cpp-master/include -DUSE_$method -DRNG_INCLUDE=$line[1] -DRNG_TYPE=$line[2] $line[3,-1] -o $EXECDIR/stream.$line[2].$method.gcc
+echo $CLANGPLUSPLUS stream.cpp -Ipcg-cpp-master/include -DUSE_$method -DRNG_INCLUDE=$line[1] -DRNG_TYPE=$line[2] $line[3,-1] -o $EXECDIR/stream.$line[2].$method.clang
 end
-done < schemes-64.dat
+done
 
-} | perl -lane 'BEGIN { print "# This Makefile was auto-generated by gen-makefile.sh\n\nall: targets\n" } s/(["<])(.*?)([>"])/\\$1$2\\$3/g; m/(\w+\.cpp)/ or die "?"; print "$F[-1]: $1\n\t$_\n"; push @execs, $F[-1]; END { print "clean:\n\trm -f @execs\n"; print "targets: @execs\n"; }' > Makefile
+} | perl -lane 'BEGIN { print "# This Makefile was auto-generated by gen-makefile.sh\n\nall: targets\n" } s/(["<])(.*?)([>"])/\\$1$2\\$3/g; m/([\w-]+\.cpp)/ or die "?"; print "$F[-1]: $1\n\t$_\n"; push @execs, $F[-1]; END { print "clean:\n\trm -f @execs\n"; print "targets: @execs\n"; }' > Makefile
 
 mkdir -p $EXECDIR
@@ -0,0 +1,22 @@
+#!/bin/zsh
+
+# Usage: gen-pressure-tests.sh corunner|sweep seed...
+#
+# Runs every bounded32 and bounded64 build under cache pressure (see
+# pressure.hpp), writing out/corunner32.*, out/sweep64.*, etc.  Settings
+# such as CACHE_PRESSURE_BYTES are passed through from the environment.
+
+mode=$1
+shift
+
+for seed in "$@"
+do
+    for prog in tests/bounded*[gc]
+    do
+	echo "CACHE_PRESSURE=$mode $prog $seed > out/${prog:t:s/bounded/$mode/}.$seed.out"
+    done
+done | \
+perl -e 'use strict; my @lines = (<>); while (@lines) { print splice @lines, rand(@lines), 1; }' | \
+perl -lane 'BEGIN { print "# This Makefile was auto-generated by gen-pressure-tests.sh\n\nall: targets\n" } m{(tests/\S+)} or die "?"; print "$F[-1]: $1\n\t$_\n"; push @outs, $F[-1]; END { print "clean:\n\trm -f @outs\n"; print "targets: @outs\n"; }' > Makefile.$mode
+
+mkdir -p out
@@ -0,0 +1,157 @@
+/*
+ * A C++ generator of synthetic range traces for bounded32 and bounded64
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2018 Melissa E. O'Neill
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <iostream>
+#include <cstdint>
+#include <cstdlib>
+#include <cstdio>
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <vector>
+#include <algorithm>
+#include "pcg_random.hpp"
+#include "bounded.hpp"
+
+using rng_t = pcg64;
+
+// Number of distinct ranges in a Zipf mix, and the Zipf exponent
+#ifndef ZIPF_RANGES
+    #define ZIPF_RANGES 1024
+#endif
+
+#ifndef ZIPF_EXPONENT
+    #define ZIPF_EXPONENT 1.0
+#endif
+
+/*
+ * Each mix is a function returning successive ranges of at most bits bits.
+ *
+ *   loguniform: bit width uniform in 1..bits, then uniform within that
+ *               width (Test 3's ranges, in random order).
+ *   zipf:       ZIPF_RANGES distinct log-uniform ranges, the k-th most
+ *               popular drawn with probability proportional to
+ *               1/k^ZIPF_EXPONENT, so a few hot ranges and a long tail.
+ *   fixed:      a handful of typical ranges (dice, cards, and so on), each
+ *               equally likely.
+ */
+
+static uint64_t loguniform_range(rng_t& rng, unsigned bits) {
+    uint64_t bit = uint64_t(1) << bounded_rand_any(rng, bits);
+    return bit | (rand64(rng) & (bit - 1));
+}
+
+static std::vector<uint64_t> fixed_ranges(unsigned bits) {
+    std::vector<uint64_t> ranges = { 2, 6, 52, 100, 1000, 0x10001,
+				     0x80000001, 0xfffffffb };
+    if (bits == 64) {
+	ranges.push_back(0x123456789ab);
+	ranges.push_back(0x8000000000000001);
+    }
+    return ranges;
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc < 5) {
+	std::cerr << "Usage: " << argv[0]
+		  << " loguniform|zipf|fixed 32|64 count file [seed]\n";
+	return 1;
+    }
+    const char* mix = argv[1];
+    unsigned bits = atoi(argv[2]);
+    uint64_t count = strtoull(argv[3], nullptr, 0);
+    const char* path = argv[4];
+    uint64_t seed;
+    if (argc <= 5) {
+	std::random_device rdev;
+	seed = rdev();
+	seed <<= 32;
+	seed |= rdev();
+    } else {
+	seed = strtoul(argv[5], nullptr, 0);
+    }
+    if (bits != 32 && bits != 64) {
+	std::cerr << argv[0] << ": width must be 32 or 64\n";
+	return 1;
+    }
+    rng_t rng(seed);
+
+    std::vector<uint64_t> ranges;
+    std::vector<double> cdf;			// for zipf
+    if (strcmp(mix, "zipf") == 0) {
+	double total = 0;
+	for (unsigned k = 1; k <= ZIPF_RANGES; ++k) {
+	    ranges.push_back(loguniform_range(rng, bits));
+	    total += 1.0 / pow(k, ZIPF_EXPONENT);
+	    cdf.push_back(total);
+	}
+	for (double& c : cdf)
+	    c /= total;
+    } else if (strcmp(mix, "fixed") == 0) {
+	ranges = fixed_ranges(bits);
+    } else if (strcmp(mix, "loguniform") != 0) {
+	std::cerr << argv[0] << ": unknown mix " << mix << "\n";
+	return 1;
+    }
+
+    FILE* out = fopen(path, "wb");
+    if (!out) {
+	perror(path);
+	return 1;
+    }
+    constexpr size_t CHUNK = 4096;
+    uint64_t buffer64[CHUNK];
+    uint32_t buffer32[CHUNK];
+    for (uint64_t i = 0; i < count; i += CHUNK) {
+	size_t n = count - i < CHUNK ? count - i : CHUNK;
+	for (size_t j = 0; j < n; ++j) {
+	    uint64_t range;
+	    if (!cdf.empty()) {
+		double u = uniform01_open(rng);
+		size_t k = std::upper_bound(cdf.begin(), cdf.end(), u)
+			   - cdf.begin();
+		range = ranges[k < ranges.size() ? k : ranges.size() - 1];
+	    } else if (!ranges.empty()) {
+		range = ranges[bounded_rand_any(rng, ranges.size())];
+	    } else {
+		range = loguniform_range(rng, bits);
+	    }
+	    buffer64[j] = range;
+	    buffer32[j] = uint32_t(range);
+	}
+	size_t written = bits == 64 ? fwrite(buffer64, sizeof(uint64_t), n, out)
+				    : fwrite(buffer32, sizeof(uint32_t), n, out);
+	if (written != n) {
+	    perror(path);
+	    return 1;
+	}
+    }
+    if (fclose(out) != 0) {
+	perror(path);
+	return 1;
+    }
+}
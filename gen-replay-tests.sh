@@ -0,0 +1,32 @@
+#!/bin/zsh
+
+# Usage: gen-replay-tests.sh seed trace...
+#
+# Replays each trace through every bounded32 or bounded64 build, according
+# to whether its name ends in .r32 or .r64 (see gen-ranges.cpp).
+
+seed=$1
+shift
+traces32=(${(M)argv:#*.r32})
+traces64=(${(M)argv:#*.r64})
+
+{
+    if (( $#traces32 ))
+    then
+	for prog in tests/bounded32.*[gc]
+	do
+	    echo "$prog $seed $traces32 > out/${prog:t:s/bounded/replay/}.$seed.out"
+	done
+    fi
+    if (( $#traces64 ))
+    then
+	for prog in tests/bounded64.*[gc]
+	do
+	    echo "$prog $seed $traces64 > out/${prog:t:s/bounded/replay/}.$seed.out"
+	done
+    fi
+} | \
+perl -e 'use strict; my @lines = (<>); while (@lines) { print splice @lines, rand(@lines), 1; }' | \
+perl -lane 'BEGIN { print "# This Makefile was auto-generated by gen-replay-tests.sh\n\nall: targets\n" } m{(tests/\S+)} or die "?"; print "$F[-1]: $1\n\t$_\n"; push @outs, $F[-1]; END { print "clean:\n\trm -f @outs\n"; print "targets: @outs\n"; }' > Makefile.replay
+
+mkdir -p out
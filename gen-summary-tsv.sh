@@ -1,5 +1,15 @@
 #!/bin/sh
 
+# Whether any of the given files exist, for runs that are optional, such as
+# those of gen-replay-tests.sh and gen-pressure-tests.sh
+have() {
+    for file in "$@"
+    do
+	[ -e "$file" ] && return 0
+    done
+    return 1
+}
+
 ./summarize.pl --method out/bounded32.*.out > bounded32-methods.tsv
 ./summarize.pl --method out/bounded64.*.out > bounded64-methods.tsv
 
@@ -8,3 +18,38 @@
 
 ./summarize.pl --prng out/bounded32.*.out > bounded32-prngs.tsv
 ./summarize.pl --prng out/bounded64.*.out > bounded64-prngs.tsv
+
+./summarize.pl --method --bits out/bounded32.*.out > bounded32-methods-bits.tsv
+./summarize.pl --method --bits out/bounded64.*.out > bounded64-methods-bits.tsv
+./summarize.pl --method --prng --bits-calls out/bounded32.pcg*.out > bounded32-bits-calls.tsv
+./summarize.pl --method --prng --bits-calls out/bounded64.pcg*.out > bounded64-bits-calls.tsv
+
+./summarize.pl --method --prng out/bounded32.*.out > bounded32-pairs.tsv
+./summarize.pl --method --prng out/bounded64.*.out > bounded64-pairs.tsv
+for mode in corunner sweep
+do
+    for bits in 32 64
+    do
+	if have out/$mode$bits.*.out
+	then
+	    ./summarize.pl --method --prng out/$mode$bits.*.out > $mode$bits-pairs.tsv
+	    ./slowdown.pl bounded$bits-pairs.tsv $mode$bits-pairs.tsv > $mode$bits-slowdown.tsv
+	fi
+    done
+done
+
+for bits in 32 64
+do
+    if have out/replay$bits.*.out
+    then
+	./summarize.pl --method out/replay$bits.*.out > replay$bits-methods.tsv
+    fi
+done
+
+./summarize.pl --method out/shuffle4.*.out > shuffle4-methods.tsv
+./summarize.pl --method out/shuffle64.*.out > shuffle64-methods.tsv
+./summarize.pl --method out/sample.*.out > sample-methods.tsv
+./summarize.pl --method out/permutation.*.out > permutation-methods.tsv
+./summarize.pl --method out/coinflip.*.out > coinflip-methods.tsv
+./summarize.pl --method out/ring.*.out > ring-methods.tsv
+./summarize.pl --method --prng out/stream.*.out > stream-seeks.tsv
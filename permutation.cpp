@@ -0,0 +1,160 @@
+/*
+ * A C++ benchmark for visiting every index of a range in random order
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2018 Melissa E. O'Neill
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <iostream>
+#include <cstdint>
+#include <cstdlib>
+#include <cassert>
+#include <random>
+#include <vector>
+#include <string>
+#include "pcg_random.hpp"
+#include "timer.hpp"
+#include "permutation.hpp"
+#include "shuffle.hpp"
+
+#ifdef RNG_INCLUDE
+    #include RNG_INCLUDE
+#endif
+
+#ifndef RNG_TYPE
+    #define RNG_TYPE std::mt19937
+#endif
+
+using rng_t = RNG_TYPE;
+
+// At most this many indices are visited for each size; for the lazy
+// permutations that is a random sample of the range, visited in order.
+#ifndef PERM_MAX_VISIT
+    #define PERM_MAX_VISIT (1ull << 30)
+#endif
+
+// Sizes whose explicit shuffle would need more memory than this are skipped.
+#ifndef PERM_MAX_BYTES
+    #define PERM_MAX_BYTES (1ull << 32)
+#endif
+
+/*
+ * Each variant visits perm[0], ..., perm[visit-1] for a random permutation
+ * of 0..n-1 (including any setup in the time).
+ */
+
+#if USE_LAZY
+
+static bool fits(uint64_t /* n */) {
+    return true;
+}
+
+template <typename Visit>
+static void permute(rng_t& rng, uint64_t n, uint64_t visit, Visit visitor) {
+    lazy_permutation<> perm(rng, n);
+    for (uint64_t i = 0; i < visit; ++i)
+	visitor(perm[i]);
+}
+
+#elif USE_LAZY_BATCH
+
+static bool fits(uint64_t /* n */) {
+    return true;
+}
+
+template <typename Visit>
+static void permute(rng_t& rng, uint64_t n, uint64_t visit, Visit visitor) {
+    constexpr size_t BATCH = 256;
+    lazy_permutation<> perm(rng, n);
+    uint64_t buffer[BATCH];
+    for (uint64_t i = 0; i < visit; i += BATCH) {
+	size_t count = visit - i < BATCH ? visit - i : BATCH;
+	perm.evaluate(i, count, buffer);
+	for (size_t j = 0; j < count; ++j)
+	    visitor(buffer[j]);
+    }
+}
+
+#elif USE_EXPLICIT_SHUFFLE
+
+static bool fits(uint64_t n) {
+    return n <= UINT32_MAX && n <= PERM_MAX_BYTES / sizeof(uint32_t);
+}
+
+template <typename Visit>
+static void permute(rng_t& rng, uint64_t n, uint64_t visit, Visit visitor) {
+    std::vector<uint32_t> perm(n);
+    for (uint64_t i = 0; i < n; ++i)
+	perm[i] = uint32_t(i);
+    prefetch_shuffle(perm.data(), n, rng);
+    for (uint64_t i = 0; i < visit; ++i)
+	visitor(perm[i]);
+}
+
+#endif
+
+int main(int argc, char* argv[])
+{
+    uint64_t seed;
+    if (argc <= 1) {
+	std::random_device rdev;
+	seed = rdev();
+	seed <<= 32;
+	seed |= rdev();
+    } else {
+	seed = strtoul(argv[1], nullptr, 0);
+    }
+    rng_t rng(seed);
+    Timer timer;
+
+    // Range sizes, given as powers of two (default 2^20 to 2^40), for the
+    // domain the permutation works on
+    std::vector<int> exponents;
+    for (int i = 2; i < argc; ++i)
+	exponents.push_back(atoi(argv[i]));
+    if (exponents.empty())
+	exponents = {20, 24, 28, 32, 40};
+
+    for (int exponent : exponents) {
+	// Just over half of 2^exponent: the Feistel network still works on
+	// 2^exponent values, so about half of them walk, the worst case
+	// for cycle walking (about two passes per index on average).
+	uint64_t n = (uint64_t(1) << (exponent - 1)) + 1;
+	std::string what = "Permute 2^" + std::to_string(exponent - 1) + "+1";
+	if (!fits(n)) {
+	    std::cout << what << " skipped\n";
+	    continue;
+	}
+	uint64_t visit = n < PERM_MAX_VISIT ? n : PERM_MAX_VISIT;
+
+	uint64_t sum = 0, check = 0, count = 0;
+	timer.start(what.c_str());
+	permute(rng, n, visit, [&](uint64_t index) {
+	    assert(index < n);
+	    sum += index;
+	    check += count++ * index;
+	});
+	timer.done();
+	assert(visit < n || sum == n * (n - 1) / 2);
+	std::cout << "Check" << exponent << " = " << check << "\n";
+    }
+}
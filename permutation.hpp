@@ -0,0 +1,157 @@
+#ifndef PERMUTATION_HPP_INCLUDED
+#define PERMUTATION_HPP_INCLUDED
+
+/*
+ * A C++ implementation of lazily evaluated random permutations of huge
+ * index spaces, using a keyed Feistel network with cycle walking.
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2018 Melissa E. O'Neill
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <cassert>
+#include "bounded.hpp"
+
+/*
+ * lazy_permutation<Rounds> is a bijection on 0..n-1 that takes O(1) memory
+ * and can be evaluated at any index, so visiting perm[0], perm[1], ...
+ * visits every index exactly once in random order without ever
+ * materializing the shuffled array.
+ *
+ * We use a Feistel network over the b-bit integers, where 2^b is the next
+ * power of two at or above n, splitting each value into a high part of
+ * b - b/2 bits and a low part of b/2 bits.  Rounds alternate between
+ * xoring a keyed hash of the low part into the high part and a keyed hash
+ * of the high part into the low part (each masked to the width of the part
+ * it changes), which is invertible whatever the hash is.  Values that land
+ * at or above n are fed back through the network (cycle walking) until
+ * they land below n, which keeps the mapping a bijection on 0..n-1 and
+ * takes fewer than two passes on average.
+ *
+ * Both halves are at most 32 bits wide, so the round function works on
+ * 32-bit lanes, which lets the batched path vectorize.  The round keys are
+ * drawn from any generator; the result is only as random as a keyed hash,
+ * not a uniformly chosen permutation (there are far too many of those).
+ */
+
+template <unsigned Rounds = 6>
+class lazy_permutation {
+    static_assert(Rounds % 2 == 0, "need an even number of rounds");
+
+    uint64_t n_;
+    unsigned hi_bits_;
+    unsigned lo_bits_;
+    uint32_t hi_mask_;
+    uint32_t lo_mask_;
+    uint32_t keys_[Rounds];
+
+    static uint32_t mask_for(unsigned bits) {
+	return uint32_t(~uint64_t(0) >> (64 - bits));
+    }
+
+    // Chris Wellons's "lowbias32" integer hash, keyed by xoring in the key.
+    static uint32_t round_function(uint32_t x, uint32_t key) {
+	x ^= key;
+	x ^= x >> 16;
+	x *= 0x7feb352du;
+	x ^= x >> 15;
+	x *= 0x846ca68bu;
+	x ^= x >> 16;
+	return x;
+    }
+
+    uint64_t encrypt(uint64_t x) const {
+	uint32_t a = uint32_t(x >> lo_bits_);
+	uint32_t b = uint32_t(x) & lo_mask_;
+	for (unsigned r = 0; r < Rounds; r += 2) {
+	    a = (a ^ round_function(b, keys_[r])) & hi_mask_;
+	    b = (b ^ round_function(a, keys_[r+1])) & lo_mask_;
+	}
+	return (uint64_t(a) << lo_bits_) | b;
+    }
+
+public:
+    template <typename RngT>
+    lazy_permutation(RngT& rng, uint64_t n)
+	: n_(n)
+    {
+	unsigned bits = n <= 4 ? 2 : 64 - __builtin_clzll(n - 1);
+	lo_bits_ = bits / 2;
+	hi_bits_ = bits - lo_bits_;
+	hi_mask_ = mask_for(hi_bits_);
+	lo_mask_ = mask_for(lo_bits_);
+	for (unsigned r = 0; r < Rounds; ++r)
+	    keys_[r] = rand32(rng);
+    }
+
+    uint64_t size() const {
+	return n_;
+    }
+
+    uint64_t operator[](uint64_t i) const {
+	assert(i < n_);
+	uint64_t x = encrypt(i);
+	while (x >= n_)
+	    x = encrypt(x);
+	return x;
+    }
+
+    /*
+     * Batched evaluation: out[j] = (*this)[first + j] for j < count.  The
+     * first pass through the network for a block of lanes is a branch-free
+     * loop over 32-bit halves, which the compiler can vectorize; the few
+     * lanes that need cycle walking are finished off one at a time
+     * afterwards.
+     */
+    void evaluate(uint64_t first, size_t count, uint64_t* out) const {
+	constexpr size_t LANES = 16;
+	assert(first + count <= n_);
+	while (count > 0) {
+	    size_t lanes = count < LANES ? count : LANES;
+	    uint32_t a[LANES], b[LANES];
+	    for (size_t l = 0; l < LANES; ++l) {
+		uint64_t x = first + l;
+		uint32_t al = uint32_t(x >> lo_bits_) & hi_mask_;
+		uint32_t bl = uint32_t(x) & lo_mask_;
+		for (unsigned r = 0; r < Rounds; r += 2) {
+		    al = (al ^ round_function(bl, keys_[r])) & hi_mask_;
+		    bl = (bl ^ round_function(al, keys_[r+1])) & lo_mask_;
+		}
+		a[l] = al;
+		b[l] = bl;
+	    }
+	    for (size_t l = 0; l < lanes; ++l) {
+		uint64_t x = (uint64_t(a[l]) << lo_bits_) | b[l];
+		while (x >= n_)
+		    x = encrypt(x);
+		out[l] = x;
+	    }
+	    first += lanes;
+	    count -= lanes;
+	    out += lanes;
+	}
+    }
+};
+
+#endif // PERMUTATION_HPP_INCLUDED
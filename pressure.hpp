@@ -0,0 +1,200 @@
+#ifndef PRESSURE_HPP_INCLUDED
+#define PRESSURE_HPP_INCLUDED
+
+/*
+ * A C++ implementation of cache pressure for benchmarks: evicting the
+ * caches while a benchmark runs, either from a co-runner thread or by
+ * periodically sweeping memory on the benchmark's own thread.
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2018 Melissa E. O'Neill
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <stdexcept>
+#include <system_error>
+#include <cerrno>
+#include <signal.h>
+#include <sys/time.h>
+#include <time.h>
+
+/*
+ * The mode comes from the environment, so any benchmark binary can be run
+ * under pressure without rebuilding it:
+ *
+ *   CACHE_PRESSURE=corunner   a thread sweeps a buffer continuously.  It
+ *                             contends for the shared last-level cache
+ *                             (and for L1/L2 if it lands on a hyperthread
+ *                             sibling), so it needs a spare core; on a
+ *                             single core it just steals time.
+ *   CACHE_PRESSURE=sweep      an interval timer interrupts the benchmark
+ *                             and its signal handler sweeps the buffer on
+ *                             the benchmark's own core, evicting L1 and L2
+ *                             too.  The time spent sweeping is counted by
+ *                             sweep_seconds(), so Timer can leave it out.
+ *   CACHE_PRESSURE_BYTES      buffer size (default 32 MiB, enough to
+ *                             evict most last-level caches)
+ *   CACHE_PRESSURE_INTERVAL   microseconds between sweeps (default 10000)
+ *
+ * Each sweep writes to every cache line of the buffer, so evicted lines
+ * are dirty and have to be written back, as in a busy service.
+ *
+ * Only one cache_pressure may be active at a time.
+ */
+
+class cache_pressure {
+public:
+    enum mode { NONE, CORUNNER, SWEEP };
+
+private:
+    static constexpr size_t LINE_SIZE = 64;
+
+    mode mode_ = NONE;
+    size_t bytes_ = size_t(32) << 20;
+    unsigned interval_ = 10000;
+    std::atomic<bool> stop_{false};
+    std::thread thread_;
+
+    static inline volatile char* buffer_ = nullptr;
+    static inline size_t buffer_bytes_ = 0;
+    static inline std::atomic<uint64_t> sweep_ns_{0};
+
+    static void sweep() {
+	for (size_t i = 0; i < buffer_bytes_; i += LINE_SIZE)
+	    buffer_[i] = buffer_[i] + 1;
+    }
+
+    static uint64_t now_ns() {
+	timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);	// async-signal-safe
+	return uint64_t(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+    }
+
+    static void on_alarm(int) {
+	int saved_errno = errno;
+	uint64_t start = now_ns();
+	sweep();
+	sweep_ns_.fetch_add(now_ns() - start, std::memory_order_relaxed);
+	errno = saved_errno;
+    }
+
+    static std::system_error error(const char* what) {
+	return std::system_error(errno, std::generic_category(), what);
+    }
+
+public:
+    cache_pressure() {
+	const char* setting = getenv("CACHE_PRESSURE");
+	if (!setting || !*setting || strcmp(setting, "none") == 0)
+	    return;
+	if (strcmp(setting, "corunner") == 0)
+	    mode_ = CORUNNER;
+	else if (strcmp(setting, "sweep") == 0)
+	    mode_ = SWEEP;
+	else
+	    throw std::runtime_error(std::string("CACHE_PRESSURE: unknown mode ")
+				     + setting);
+	if (const char* bytes = getenv("CACHE_PRESSURE_BYTES"))
+	    bytes_ = strtoull(bytes, nullptr, 0);
+	if (const char* interval = getenv("CACHE_PRESSURE_INTERVAL"))
+	    interval_ = strtoul(interval, nullptr, 0);
+	if (bytes_ < LINE_SIZE || interval_ == 0)
+	    throw std::runtime_error("CACHE_PRESSURE: bad size or interval");
+
+	buffer_ = static_cast<volatile char*>(calloc(bytes_, 1));
+	if (!buffer_)
+	    throw std::bad_alloc();
+	buffer_bytes_ = bytes_;
+
+	if (mode_ == CORUNNER) {
+	    thread_ = std::thread([this] {
+		while (!stop_.load(std::memory_order_relaxed))
+		    sweep();
+	    });
+	} else {
+	    struct sigaction action;
+	    memset(&action, 0, sizeof(action));
+	    action.sa_handler = on_alarm;
+	    action.sa_flags = SA_RESTART;
+	    sigemptyset(&action.sa_mask);
+	    if (sigaction(SIGALRM, &action, nullptr) != 0)
+		throw error("sigaction");
+	    itimerval timer;
+	    timer.it_interval.tv_sec = interval_ / 1000000;
+	    timer.it_interval.tv_usec = interval_ % 1000000;
+	    timer.it_value = timer.it_interval;
+	    if (setitimer(ITIMER_REAL, &timer, nullptr) != 0)
+		throw error("setitimer");
+	}
+    }
+
+    cache_pressure(const cache_pressure&) = delete;
+    cache_pressure& operator=(const cache_pressure&) = delete;
+
+    ~cache_pressure() {
+	if (mode_ == CORUNNER) {
+	    stop_.store(true);
+	    thread_.join();
+	} else if (mode_ == SWEEP) {
+	    itimerval timer;
+	    memset(&timer, 0, sizeof(timer));
+	    setitimer(ITIMER_REAL, &timer, nullptr);
+	    signal(SIGALRM, SIG_DFL);
+	}
+	if (mode_ != NONE) {
+	    free(const_cast<char*>(buffer_));
+	    buffer_ = nullptr;
+	    buffer_bytes_ = 0;
+	}
+    }
+
+    bool active() const {
+	return mode_ != NONE;
+    }
+
+    // A one-line description of the setting, for the benchmark's output.
+    std::string description() const {
+	switch (mode_) {
+	case CORUNNER:
+	    return "co-runner thread sweeping " + std::to_string(bytes_)
+		   + " bytes";
+	case SWEEP:
+	    return "sweeping " + std::to_string(bytes_) + " bytes every "
+		   + std::to_string(interval_) + " us";
+	default:
+	    return "none";
+	}
+    }
+
+    // Total time spent in sweeps on the benchmark's thread.
+    static double sweep_seconds() {
+	return sweep_ns_.load(std::memory_order_relaxed) * 1e-9;
+    }
+};
+
+#endif // PRESSURE_HPP_INCLUDED
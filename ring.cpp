@@ -0,0 +1,218 @@
+/*
+ * A C++ benchmark for serving bounded random numbers from pre-generated
+ * ring buffers
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2018 Melissa E. O'Neill
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <iostream>
+#include <cstdint>
+#include <cstdlib>
+#include <cassert>
+#include <chrono>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/wait.h>
+#include "pcg_random.hpp"
+#include "timer.hpp"
+#include "ring.hpp"
+
+#ifdef RNG_INCLUDE
+    #include RNG_INCLUDE
+#endif
+
+#ifndef RNG_TYPE
+    #define RNG_TYPE std::mt19937
+#endif
+
+using rng_t = RNG_TYPE;
+using ring_t = bounded_ring<>;
+
+// Values drawn by each consumer thread
+#ifndef RING_DRAWS
+    #define RING_DRAWS (1u << 24)
+#endif
+
+static const std::vector<uint64_t> ranges = {
+    6, 52, 1000, 0x10001, 0x80000001, 0x123456789ab
+};
+
+/*
+ * Consumers draw from the ranges in turn.  With rings, a consumer that
+ * finds its ring empty generates the value inline from its own generator
+ * instead of waiting, and counts a miss.
+ */
+
+struct consumer_result {
+    uint64_t sum = 0;
+    uint64_t misses = 0;
+    double seconds = 0;
+};
+
+static void consume(ring_t* rings, rng_t rng, consumer_result& result) {
+    auto start = std::chrono::steady_clock::now();
+    uint64_t sum = 0, misses = 0;
+    size_t which = 0;
+    for (uint32_t i = 0; i < RING_DRAWS; ++i) {
+	uint64_t range = ranges[which];
+	uint64_t value;
+	if (!rings || !rings[which].try_get(value)) {
+	    value = bounded_rand_any(rng, range);
+	    ++misses;
+	}
+	assert(value < range);
+	sum += value;
+	if (++which == ranges.size())
+	    which = 0;
+    }
+    std::chrono::duration<double> elapsed =
+	std::chrono::steady_clock::now() - start;
+    result.sum = sum;
+    result.misses = misses;
+    result.seconds = elapsed.count();
+}
+
+static std::vector<consumer_result> run_consumers(ring_t* rings,
+						  unsigned nthreads,
+						  uint64_t seed) {
+    std::vector<consumer_result> results(nthreads);
+    std::vector<std::thread> threads;
+    for (unsigned t = 0; t < nthreads; ++t)
+	threads.emplace_back(consume, rings, rng_t(seed + t + 1),
+			     std::ref(results[t]));
+    for (auto& thread : threads)
+	thread.join();
+    return results;
+}
+
+#if USE_INLINE
+
+static std::vector<consumer_result> serve(unsigned nthreads, uint64_t seed) {
+    return run_consumers(nullptr, nthreads, seed);
+}
+
+#elif USE_RING
+
+static std::vector<consumer_result> serve(unsigned nthreads, uint64_t seed) {
+    void* memory = operator new[](ranges.size() * sizeof(ring_t),
+				  std::align_val_t(alignof(ring_t)));
+    ring_t* ring_array = static_cast<ring_t*>(memory);
+    for (size_t i = 0; i < ranges.size(); ++i)
+	new (&ring_array[i]) ring_t(ranges[i]);
+
+    rng_t rng(seed);
+    ring_producer<rng_t, ring_t> producer(rng);
+    for (size_t i = 0; i < ranges.size(); ++i)
+	producer.add(ring_array[i]);
+    producer.fill();
+    producer.start();
+    auto results = run_consumers(ring_array, nthreads, seed);
+    producer.stop();
+
+    for (size_t i = 0; i < ranges.size(); ++i)
+	ring_array[i].~ring_t();
+    operator delete[](memory, std::align_val_t(alignof(ring_t)));
+    return results;
+}
+
+#elif USE_SHARED_RING
+
+// The producer runs in a child process, sharing the rings through POSIX
+// shared memory.
+
+static std::vector<consumer_result> serve(unsigned nthreads, uint64_t seed) {
+    std::string name = "/bounded-rands-" + std::to_string(getpid());
+    auto shared = shared_rings<ring_t>::create(name.c_str(), ranges);
+    shared_rings<ring_t>::unlink(name.c_str());	// freed once unmapped
+
+    // Fill the rings before forking, as with USE_RING; the child carries
+    // on from the same generator state.
+    rng_t rng(seed);
+    ring_producer<rng_t, ring_t> producer(rng);
+    for (size_t i = 0; i < shared.size(); ++i)
+	producer.add(shared.ring(i));
+    producer.fill();
+
+    pid_t child = fork();
+    if (child < 0)
+	throw std::system_error(errno, std::generic_category(), "fork");
+    if (child == 0) {
+	producer.run(shared.stop_flag());
+	_exit(0);
+    }
+
+    auto results = run_consumers(&shared.ring(0), nthreads, seed);
+    shared.stop_flag().store(true);
+    waitpid(child, nullptr, 0);
+    return results;
+}
+
+#endif
+
+int main(int argc, char* argv[])
+{
+    uint64_t seed;
+    if (argc <= 1) {
+	std::random_device rdev;
+	seed = rdev();
+	seed <<= 32;
+	seed |= rdev();
+    } else {
+	seed = strtoul(argv[1], nullptr, 0);
+    }
+    Timer timer;
+
+    // Numbers of consumer threads (default 1, 2, 4, 8)
+    std::vector<unsigned> thread_counts;
+    for (int i = 2; i < argc; ++i)
+	thread_counts.push_back(atoi(argv[i]));
+    if (thread_counts.empty())
+	thread_counts = {1, 2, 4, 8};
+
+    for (unsigned nthreads : thread_counts) {
+	std::string what = "Consumers " + std::to_string(nthreads);
+	timer.start(what.c_str());
+	auto start = std::chrono::steady_clock::now();
+	auto results = serve(nthreads, seed);
+	std::chrono::duration<double> elapsed =
+	    std::chrono::steady_clock::now() - start;
+	timer.done();
+
+	uint64_t sum = 0, misses = 0;
+	double worst = 0;
+	for (auto& result : results) {
+	    sum += result.sum;
+	    misses += result.misses;
+	    double ns = result.seconds * 1e9 / RING_DRAWS;
+	    if (ns > worst)
+		worst = ns;
+	}
+	double draws = double(RING_DRAWS) * nthreads;
+	std::cout << what << ": " << worst << " ns per draw (slowest consumer), "
+		  << draws / elapsed.count() / 1e6 << " million draws/s, "
+		  << misses / draws * 100 << "% generated inline\n";
+	std::cout << "Sum" << nthreads << " = " << sum << "\n";
+    }
+}
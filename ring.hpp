@@ -0,0 +1,282 @@
+#ifndef RING_HPP_INCLUDED
+#define RING_HPP_INCLUDED
+
+/*
+ * A C++ implementation of lock-free ring buffers of pre-generated bounded
+ * random numbers, filled by a background producer thread or process.
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2018 Melissa E. O'Neill
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+#include <new>
+#include <thread>
+#include <vector>
+#include <system_error>
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "bounded.hpp"
+
+/*
+ * A bounded_ring holds pre-generated values in [0, range) for one range.
+ * It has a single producer and any number of consumers, and is a bounded
+ * queue in the style of Dmitry Vyukov's: each slot carries a sequence
+ * number saying whether it is ready to be written (seq == pos) or read
+ * (seq == pos + 1) for position pos.  A consumer takes a value with one
+ * load of the slot and a compare-and-swap to bump the read index; if the
+ * ring is empty try_get fails at once, so the caller can generate a value
+ * inline rather than wait.
+ *
+ * The ring is a standard-layout block of memory with no pointers, so it
+ * can also live in shared memory (see shared_rings below).
+ */
+
+template <size_t Capacity = 4096>
+class bounded_ring {
+    static_assert((Capacity & (Capacity - 1)) == 0,
+		  "Capacity must be a power of two");
+    static_assert(std::atomic<uint64_t>::is_always_lock_free,
+		  "need lock-free 64-bit atomics");
+
+    struct slot {
+	std::atomic<uint64_t> seq;
+	uint64_t value;
+    };
+
+    uint64_t range_;
+    alignas(64) std::atomic<uint64_t> read_;
+    alignas(64) uint64_t write_;		// only touched by the producer
+    alignas(64) slot slots_[Capacity];
+
+public:
+    explicit bounded_ring(uint64_t range)
+	: range_(range), read_(0), write_(0)
+    {
+	for (size_t i = 0; i < Capacity; ++i)
+	    slots_[i].seq.store(i, std::memory_order_relaxed);
+    }
+
+    uint64_t range() const {
+	return range_;
+    }
+
+    // Producer side; only one thread may call these.
+    bool writable() const {
+	const slot& s = slots_[write_ % Capacity];
+	return s.seq.load(std::memory_order_acquire) == write_;
+    }
+
+    void put(uint64_t value) {
+	slot& s = slots_[write_ % Capacity];
+	s.value = value;
+	s.seq.store(write_ + 1, std::memory_order_release);
+	++write_;
+    }
+
+    // Consumer side; any number of threads may call this.
+    bool try_get(uint64_t& value) {
+	uint64_t pos = read_.load(std::memory_order_relaxed);
+	for (;;) {
+	    slot& s = slots_[pos % Capacity];
+	    uint64_t seq = s.seq.load(std::memory_order_acquire);
+	    if (seq == pos + 1) {
+		if (read_.compare_exchange_weak(pos, pos + 1,
+						std::memory_order_relaxed)) {
+		    value = s.value;
+		    s.seq.store(pos + Capacity, std::memory_order_release);
+		    return true;
+		}
+	    } else if (seq <= pos) {
+		return false;			// empty
+	    } else {
+		pos = read_.load(std::memory_order_relaxed);
+	    }
+	}
+    }
+};
+
+/*
+ * Fills a set of rings from one generator until told to stop, either on a
+ * thread of its own (start/stop) or by calling run directly, e.g., in a
+ * separate process.
+ */
+
+template <typename RngT, typename Ring>
+class ring_producer {
+    RngT& rng_;
+    std::vector<Ring*> rings_;
+    std::atomic<bool> stop_{false};
+    std::thread thread_;
+
+public:
+    ring_producer(RngT& rng) : rng_(rng) {}
+
+    ~ring_producer() {
+	stop();
+    }
+
+    void add(Ring& ring) {
+	rings_.push_back(&ring);
+    }
+
+    // Top up every ring; returns whether anything needed doing.
+    bool fill() {
+	bool busy = false;
+	for (Ring* ring : rings_) {
+	    uint64_t range = ring->range();
+	    while (ring->writable()) {
+		ring->put(bounded_rand_any(rng_, range));
+		busy = true;
+	    }
+	}
+	return busy;
+    }
+
+    void run(const std::atomic<bool>& stop) {
+	while (!stop.load(std::memory_order_relaxed)) {
+	    if (!fill())
+		std::this_thread::yield();
+	}
+    }
+
+    void start() {
+	stop_.store(false);
+	thread_ = std::thread([this] { run(stop_); });
+    }
+
+    void stop() {
+	if (thread_.joinable()) {
+	    stop_.store(true);
+	    thread_.join();
+	}
+    }
+};
+
+/*
+ * A set of rings in POSIX shared memory, so that a producer in one process
+ * can serve consumers in others.  The creator constructs the rings; other
+ * processes attach to them by name.  The stop flag lets the creator shut
+ * down a producer running in another process.
+ */
+
+template <typename Ring>
+class shared_rings {
+    struct header {
+	std::atomic<bool> stop;
+	size_t count;
+    };
+
+    static constexpr size_t RINGS_OFFSET =
+	(sizeof(header) + alignof(Ring) - 1) / alignof(Ring) * alignof(Ring);
+
+    void* base_ = nullptr;
+    size_t bytes_ = 0;
+
+    static void* map(int fd, size_t bytes) {
+	void* base = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED,
+			  fd, 0);
+	int err = errno;
+	close(fd);
+	if (base == MAP_FAILED)
+	    throw std::system_error(err, std::generic_category(), "mmap");
+	return base;
+    }
+
+    header& head() const {
+	return *static_cast<header*>(base_);
+    }
+
+    shared_rings(void* base, size_t bytes) : base_(base), bytes_(bytes) {}
+
+public:
+    shared_rings(const shared_rings&) = delete;
+    shared_rings(shared_rings&& other)
+	: base_(other.base_), bytes_(other.bytes_)
+    {
+	other.base_ = nullptr;
+    }
+
+    ~shared_rings() {
+	if (base_)
+	    munmap(base_, bytes_);
+    }
+
+    static shared_rings create(const char* name,
+			       const std::vector<uint64_t>& ranges) {
+	size_t bytes = RINGS_OFFSET + ranges.size() * sizeof(Ring);
+	int fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0600);
+	if (fd < 0)
+	    throw std::system_error(errno, std::generic_category(), name);
+	if (ftruncate(fd, bytes) != 0) {
+	    int err = errno;
+	    close(fd);
+	    shm_unlink(name);
+	    throw std::system_error(err, std::generic_category(), "ftruncate");
+	}
+	shared_rings result(map(fd, bytes), bytes);
+	header* h = new (result.base_) header;
+	h->stop.store(false);
+	h->count = ranges.size();
+	for (size_t i = 0; i < ranges.size(); ++i)
+	    new (&result.ring(i)) Ring(ranges[i]);
+	return result;
+    }
+
+    static shared_rings attach(const char* name) {
+	int fd = shm_open(name, O_RDWR, 0);
+	if (fd < 0)
+	    throw std::system_error(errno, std::generic_category(), name);
+	struct stat info;
+	if (fstat(fd, &info) != 0) {
+	    int err = errno;
+	    close(fd);
+	    throw std::system_error(err, std::generic_category(), "fstat");
+	}
+	size_t bytes = info.st_size;
+	return shared_rings(map(fd, bytes), bytes);
+    }
+
+    static void unlink(const char* name) {
+	shm_unlink(name);
+    }
+
+    size_t size() const {
+	return head().count;
+    }
+
+    Ring& ring(size_t i) const {
+	char* rings = static_cast<char*>(base_) + RINGS_OFFSET;
+	return reinterpret_cast<Ring*>(rings)[i];
+    }
+
+    std::atomic<bool>& stop_flag() const {
+	return head().stop;
+    }
+};
+
+#endif // RING_HPP_INCLUDED
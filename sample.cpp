@@ -0,0 +1,158 @@
+/*
+ * A C++ benchmark for generating sorted random samples
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2018 Melissa E. O'Neill
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <iostream>
+#include <cstdint>
+#include <cstdlib>
+#include <cassert>
+#include <random>
+#include <algorithm>
+#include <unordered_set>
+#include <vector>
+#include <string>
+#include "pcg_random.hpp"
+#include "timer.hpp"
+#include "sample.hpp"
+
+#ifdef RNG_INCLUDE
+    #include RNG_INCLUDE
+#endif
+
+#ifndef RNG_TYPE
+    #define RNG_TYPE std::mt19937
+#endif
+
+using rng_t = RNG_TYPE;
+
+// Samples of k are drawn from a population of SAMPLE_RATIO * k indices.
+#ifndef SAMPLE_RATIO
+    #define SAMPLE_RATIO 100
+#endif
+
+// Sizes that would need more work (Method A) or memory (sorting) than
+// this are skipped.
+#ifndef SAMPLE_MAX_COST
+    #define SAMPLE_MAX_COST (1ull << 34)
+#endif
+
+#if USE_METHOD_A
+
+static uint64_t cost(uint64_t /* k */, uint64_t n) {
+    return n;
+}
+
+template <typename Visit>
+static void sample(rng_t& rng, uint64_t k, uint64_t n, Visit visit) {
+    vitter_a_sampler<rng_t> sampler(rng, k, n);
+    while (!sampler.done())
+	visit(sampler.next());
+}
+
+#elif USE_METHOD_D
+
+static uint64_t cost(uint64_t k, uint64_t /* n */) {
+    return k;
+}
+
+template <typename Visit>
+static void sample(rng_t& rng, uint64_t k, uint64_t n, Visit visit) {
+    vitter_d_sampler<rng_t> sampler(rng, k, n);
+    while (!sampler.done())
+	visit(sampler.next());
+}
+
+#elif USE_FLOYD_SORT
+
+// Floyd's algorithm followed by a sort, holding all k values in memory.
+
+static uint64_t cost(uint64_t k, uint64_t /* n */) {
+    return 64 * k;
+}
+
+template <typename Visit>
+static void sample(rng_t& rng, uint64_t k, uint64_t n, Visit visit) {
+    std::unordered_set<uint64_t> chosen;
+    chosen.reserve(k);
+    for (uint64_t j = n - k; j < n; ++j) {
+	uint64_t t = bounded_rand64(rng, j + 1);
+	if (!chosen.insert(t).second)
+	    chosen.insert(j);
+    }
+    std::vector<uint64_t> sorted(chosen.begin(), chosen.end());
+    std::sort(sorted.begin(), sorted.end());
+    for (uint64_t v : sorted)
+	visit(v);
+}
+
+#endif
+
+int main(int argc, char* argv[])
+{
+    uint64_t seed;
+    if (argc <= 1) {
+	std::random_device rdev;
+	seed = rdev();
+	seed <<= 32;
+	seed |= rdev();
+    } else {
+	seed = strtoul(argv[1], nullptr, 0);
+    }
+    rng_t rng(seed);
+    Timer timer;
+
+    // Sample sizes, given as powers of ten (default 10^3 to 10^9)
+    std::vector<int> exponents;
+    for (int i = 2; i < argc; ++i)
+	exponents.push_back(atoi(argv[i]));
+    if (exponents.empty())
+	exponents = {3, 4, 5, 6, 7, 8, 9};
+
+    for (int exponent : exponents) {
+	uint64_t k = 1;
+	for (int e = 0; e < exponent; ++e)
+	    k *= 10;
+	uint64_t n = SAMPLE_RATIO * k;
+	if (cost(k, n) > SAMPLE_MAX_COST) {
+	    std::cout << "Sample 10^" << exponent << " skipped\n";
+	    continue;
+	}
+
+	uint64_t sum = 0;
+	uint64_t count = 0;
+	uint64_t prev = 0;
+	std::string what = "Sample 10^" + std::to_string(exponent);
+	timer.start(what.c_str());
+	sample(rng, k, n, [&](uint64_t index) {
+	    assert(index < n && (count == 0 || index > prev));
+	    prev = index;
+	    sum += index;
+	    ++count;
+	});
+	timer.done();
+	assert(count == k);
+	std::cout << "Sum" << exponent << " = " << sum << "\n";
+    }
+}
@@ -0,0 +1,201 @@
+#ifndef SAMPLE_HPP_INCLUDED
+#define SAMPLE_HPP_INCLUDED
+
+/*
+ * A C++ implementation of sequential random sampling (Vitter's Methods A
+ * and D), producing a sorted random sample one index at a time.
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2018 Melissa E. O'Neill
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <cstdint>
+#include <cmath>
+#include <cassert>
+#include "bounded.hpp"
+
+/*
+ * Both samplers choose k of the indices 0..n-1 and hand them back in
+ * increasing order, one per call to next(), using O(1) memory.  Each call
+ * works out how many indices to skip before the next selected one, based
+ * on how many indices remain to be chosen (n_) out of how many are left
+ * (N_); once only one remains to be chosen, its position is just
+ * bounded_rand64(rng, N_).
+ *
+ * See J. S. Vitter, "An Efficient Algorithm for Sequential Random
+ * Sampling", ACM Transactions on Mathematical Software 13(1), 1987.
+ */
+
+// Method A: O(n) time overall, finding each skip by sequential search.
+
+template <typename RngT>
+uint64_t vitter_a_skip(RngT& rng, uint64_t n, uint64_t N) {
+    if (n == 1)
+	return bounded_rand64(rng, N);
+    double V = uniform01_open(rng);
+    double top = double(N - n);
+    double Nreal = double(N);
+    double quot = top / Nreal;
+    uint64_t S = 0;
+    while (quot > V) {
+	++S;
+	top -= 1.0;
+	Nreal -= 1.0;
+	quot *= top / Nreal;
+    }
+    return S;
+}
+
+template <typename RngT>
+class vitter_a_sampler {
+    RngT& rng_;
+    uint64_t n_;		// still to choose
+    uint64_t N_;		// still to consider
+    uint64_t current_ = 0;	// first index not yet considered
+
+public:
+    vitter_a_sampler(RngT& rng, uint64_t k, uint64_t n)
+	: rng_(rng), n_(k), N_(n)
+    {
+	assert(k <= n);
+    }
+
+    bool done() const {
+	return n_ == 0;
+    }
+
+    uint64_t next() {
+	uint64_t S = vitter_a_skip(rng_, n_, N_);
+	uint64_t result = current_ + S;
+	current_ = result + 1;
+	N_ -= S + 1;
+	--n_;
+	return result;
+    }
+};
+
+/*
+ * Method D: O(k) time overall.  Each skip is generated directly by
+ * rejection from a continuous approximation of its distribution, so the
+ * cost doesn't depend on the skip length.  Once the sample is dense enough
+ * (13n >= N, Vitter's recommended threshold) Method A is faster, so we
+ * switch to it for the rest of the sample.
+ *
+ * vprime_ carries a random variate from one skip to the next, as in
+ * Vitter's presentation; it is only meaningful while we're using Method D.
+ */
+
+template <typename RngT>
+class vitter_d_sampler {
+    static constexpr uint64_t ALPHA_INV = 13;
+
+    RngT& rng_;
+    uint64_t n_;		// still to choose
+    uint64_t N_;		// still to consider
+    uint64_t current_ = 0;	// first index not yet considered
+    bool use_a_;
+    double vprime_ = 0.0;
+
+    double power_uniform(double exponent) {
+	return exp(log(uniform01_open(rng_)) * exponent);
+    }
+
+    uint64_t d_skip() {
+	double nreal = double(n_);
+	double Nreal = double(N_);
+	double ninv = 1.0 / nreal;
+	double nmin1inv = 1.0 / (nreal - 1.0);
+	uint64_t qu1 = N_ - n_ + 1;
+	double qu1real = double(qu1);
+	uint64_t S;
+
+	for (;;) {
+	    // Step D2: generate X (and S) from the approximating density
+	    double X;
+	    for (;;) {
+		X = Nreal * (1.0 - vprime_);
+		S = uint64_t(X);
+		if (S < qu1)
+		    break;
+		vprime_ = power_uniform(ninv);
+	    }
+	    double U = uniform01_open(rng_);
+	    double negSreal = -double(S);
+
+	    // Step D3: accept using the quick test?
+	    double y1 = exp(log(U * Nreal / qu1real) * nmin1inv);
+	    vprime_ = y1 * (1.0 - X / Nreal) * (qu1real / (negSreal + qu1real));
+	    if (vprime_ <= 1.0)
+		break;
+
+	    // Step D4: accept using the exact test?
+	    double y2 = 1.0;
+	    double top = Nreal - 1.0;
+	    double bottom, limit;
+	    if (nreal - 1.0 > double(S)) {
+		bottom = Nreal - nreal;
+		limit = Nreal - double(S);
+	    } else {
+		bottom = negSreal + Nreal - 1.0;
+		limit = qu1real;
+	    }
+	    for (double t = Nreal - 1.0; t >= limit; t -= 1.0) {
+		y2 = (y2 * top) / bottom;
+		top -= 1.0;
+		bottom -= 1.0;
+	    }
+	    if (Nreal / (Nreal - X) >= y1 * exp(log(y2) * nmin1inv)) {
+		vprime_ = power_uniform(nmin1inv);
+		break;
+	    }
+	    vprime_ = power_uniform(ninv);
+	}
+	return S;
+    }
+
+public:
+    vitter_d_sampler(RngT& rng, uint64_t k, uint64_t n)
+	: rng_(rng), n_(k), N_(n), use_a_(ALPHA_INV * k >= n)
+    {
+	assert(k <= n);
+	if (!use_a_)
+	    vprime_ = power_uniform(1.0 / double(k));
+    }
+
+    bool done() const {
+	return n_ == 0;
+    }
+
+    uint64_t next() {
+	if (!use_a_ && ALPHA_INV * n_ >= N_)
+	    use_a_ = true;
+	uint64_t S = (use_a_ || n_ == 1) ? vitter_a_skip(rng_, n_, N_)
+					 : d_skip();
+	uint64_t result = current_ + S;
+	current_ = result + 1;
+	N_ -= S + 1;
+	--n_;
+	return result;
+    }
+};
+
+#endif // SAMPLE_HPP_INCLUDED
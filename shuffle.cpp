@@ -0,0 +1,158 @@
+/*
+ * A C++ benchmark for shuffling arrays much larger than the cache
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2018 Melissa E. O'Neill
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <iostream>
+#include <cstdint>
+#include <cstdlib>
+#include <cassert>
+#include <random>
+#include <algorithm>
+#include <vector>
+#include <string>
+#include "pcg_random.hpp"
+#include "timer.hpp"
+#include "shuffle.hpp"
+
+#ifdef RNG_INCLUDE
+    #include RNG_INCLUDE
+#endif
+
+#ifndef RNG_TYPE
+    #define RNG_TYPE std::mt19937
+#endif
+
+using base_rng_t = RNG_TYPE;
+using rng_t = counting_rng<base_rng_t>;
+
+// Element size in bytes; 4 is an array of indices, larger sizes model
+// shuffling records.
+#ifndef ELEM_SIZE
+    #define ELEM_SIZE 4
+#endif
+
+// Sizes that would need more memory than this are skipped.
+#ifndef SHUFFLE_MAX_BYTES
+    #define SHUFFLE_MAX_BYTES (1ull << 32)
+#endif
+
+#ifndef SHUFFLE_WINDOW
+    #define SHUFFLE_WINDOW 32
+#endif
+
+static_assert(ELEM_SIZE % sizeof(uint32_t) == 0,
+	      "ELEM_SIZE must be a multiple of 4");
+
+struct element {
+    uint32_t payload[ELEM_SIZE / sizeof(uint32_t)];
+};
+
+#if USE_STD_SHUFFLE
+
+static void shuffle(element* data, size_t n, rng_t& rng) {
+    std::shuffle(data, data + n, rng);
+}
+
+#elif USE_FISHER_YATES
+
+static void shuffle(element* data, size_t n, rng_t& rng) {
+    fisher_yates_shuffle(data, n, rng);
+}
+
+#elif USE_PREFETCH
+
+static void shuffle(element* data, size_t n, rng_t& rng) {
+    prefetch_shuffle<SHUFFLE_WINDOW>(data, n, rng);
+}
+
+#elif USE_BATCHED
+
+static void shuffle(element* data, size_t n, rng_t& rng) {
+    batched_shuffle(data, n, rng);
+}
+
+#elif USE_BATCHED_PREFETCH
+
+static void shuffle(element* data, size_t n, rng_t& rng) {
+    batched_prefetch_shuffle<SHUFFLE_WINDOW>(data, n, rng);
+}
+
+#endif
+
+int main(int argc, char* argv[])
+{
+    uint64_t seed;
+    if (argc <= 1) {
+	std::random_device rdev;
+	seed = rdev();
+	seed <<= 32;
+	seed |= rdev();
+    } else {
+	seed = strtoul(argv[1], nullptr, 0);
+    }
+    base_rng_t base_rng(seed);
+    rng_t rng(base_rng);
+    Timer timer;
+
+    // Sizes to shuffle, given as powers of ten (default 10^6 to 10^9)
+    std::vector<int> exponents;
+    for (int i = 2; i < argc; ++i)
+	exponents.push_back(atoi(argv[i]));
+    if (exponents.empty())
+	exponents = {6, 7, 8, 9};
+
+    for (int exponent : exponents) {
+	size_t n = 1;
+	for (int e = 0; e < exponent; ++e)
+	    n *= 10;
+	if (n > SHUFFLE_MAX_BYTES / sizeof(element)) {
+	    std::cout << "Shuffle 10^" << exponent << " skipped (needs "
+		      << n * sizeof(element) << " bytes)\n";
+	    continue;
+	}
+	std::vector<element> data(n);
+	for (size_t i = 0; i < n; ++i)
+	    data[i].payload[0] = uint32_t(i);
+
+	std::string what = "Shuffle 10^" + std::to_string(exponent);
+	uint64_t calls_before = rng.calls();
+	timer.start(what.c_str());
+	shuffle(data.data(), n, rng);
+	timer.done();
+	uint64_t calls = rng.calls() - calls_before;
+	std::cout << "Calls" << exponent << " = " << calls << " ("
+		  << double(calls) / n << " per element)\n";
+
+	// The plain sum checks nothing was lost; the weighted sum depends on
+	// where each element ended up.
+	uint64_t sum = 0, check = 0;
+	for (size_t i = 0; i < n; ++i) {
+	    sum += data[i].payload[0];
+	    check += i * data[i].payload[0];
+	}
+	assert(n > UINT32_MAX || sum == uint64_t(n) * (n - 1) / 2);
+	std::cout << "Check" << exponent << " = " << check << "\n";
+    }
+}
@@ -0,0 +1,243 @@
+#ifndef SHUFFLE_HPP_INCLUDED
+#define SHUFFLE_HPP_INCLUDED
+
+/*
+ * A C++ implementation of Fisher-Yates shuffling built on the bounded
+ * random number methods, including a cache-aware variant for arrays much
+ * larger than the cache.
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2018 Melissa E. O'Neill
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <type_traits>
+#include "bounded.hpp"
+
+/*
+ * All the shuffles below draw swap indices for the ranges n, n-1, ..., 2 in
+ * that order, so for a given generator state and way of drawing indices
+ * they produce identical permutations; the prefetching versions only change
+ * when memory is touched.
+ *
+ * Indices are drawn in batches: a draw function is called with the next
+ * range and fills in one or more indices, for that range and the ranges
+ * just below it, returning how many it drew (at most MAX_INDEX_BATCH).
+ */
+
+constexpr unsigned MAX_INDEX_BATCH = 6;
+
+template <typename IndexT, typename RngT>
+inline IndexT bounded_index(RngT& rng, IndexT range) {
+    if constexpr (sizeof(IndexT) <= sizeof(uint32_t))
+	return bounded_rand32(rng, range);
+    else
+	return bounded_rand64(rng, range);
+}
+
+/*
+ * For most of a Fisher-Yates pass the ranges are tiny compared to the
+ * generator's output, so a single output can supply several indices.  We
+ * multiply it through the consecutive ranges range, range-1, ... in turn,
+ * taking the high part of each product as an index and carrying the low
+ * part on to the next.  That is only unbiased if we reject the final low
+ * part against a threshold computed from the product of all the ranges
+ * (Lemire & Brackett's batched dice rolls), which generalizes the check in
+ * USE_DEBIASED_INT_MULT_TOPT.
+ */
+
+template <unsigned K, typename IndexT, typename RngT>
+inline void bounded_index_batch(RngT& rng, IndexT range, IndexT* out) {
+    constexpr bool wide = rng_is_64bit<RngT>();
+    using word_t = std::conditional_t<wide, uint64_t, uint32_t>;
+    using dword_t = std::conditional_t<wide, __uint128_t, uint64_t>;
+    constexpr unsigned WORD_BITS = sizeof(word_t) * 8;
+
+    word_t bound = 1;
+    for (unsigned i = 0; i < K; ++i)
+	bound *= word_t(range - i);
+    word_t r = wide ? word_t(rand64(rng)) : word_t(rand32(rng));
+    for (unsigned i = 0; i < K; ++i) {
+	dword_t m = dword_t(r) * dword_t(range - i);
+	out[i] = IndexT(m >> WORD_BITS);
+	r = word_t(m);
+    }
+    if (r < bound) {
+	word_t t = word_t(-bound) % bound;
+	while (r < t) {
+	    r = wide ? word_t(rand64(rng)) : word_t(rand32(rng));
+	    for (unsigned i = 0; i < K; ++i) {
+		dword_t m = dword_t(r) * dword_t(range - i);
+		out[i] = IndexT(m >> WORD_BITS);
+		r = word_t(m);
+	    }
+	}
+    }
+}
+
+/*
+ * The batch size is chosen from the current range so that the product of
+ * the ranges stays at least 2^4 below the generator's output size, which
+ * keeps rejections rare.
+ */
+
+template <typename IndexT, typename RngT>
+inline unsigned draw_index_batch(RngT& rng, IndexT range, IndexT* out) {
+    constexpr unsigned WORD_BITS = rng_is_64bit<RngT>() ? 64 : 32;
+    unsigned bits = 64 - __builtin_clzll((unsigned long long) range);
+    unsigned k = (WORD_BITS - 4) / bits;
+    if (k >= range)		// Don't run past a range of 2
+	k = range - 1;
+    switch (k) {
+    default:
+	bounded_index_batch<6>(rng, range, out);
+	return 6;
+    case 5:
+	bounded_index_batch<5>(rng, range, out);
+	return 5;
+    case 4:
+	bounded_index_batch<4>(rng, range, out);
+	return 4;
+    case 3:
+	bounded_index_batch<3>(rng, range, out);
+	return 3;
+    case 2:
+	bounded_index_batch<2>(rng, range, out);
+	return 2;
+    case 1:
+    case 0:
+	out[0] = bounded_index(rng, range);
+	return 1;
+    }
+}
+
+template <typename IndexT, typename T, typename DrawBatch>
+void fisher_yates_shuffle_impl(T* data, IndexT n, DrawBatch draw) {
+    for (IndexT i = n; i > 1; ) {
+	IndexT batch[MAX_INDEX_BATCH];
+	unsigned k = draw(i, batch);
+	for (unsigned t = 0; t < k; ++t, --i)
+	    std::swap(data[i-1], data[batch[t]]);
+    }
+}
+
+/*
+ * For arrays far larger than the last-level cache, a shuffle spends most of
+ * its time waiting on the cache miss for data[j].  Here we generate swap
+ * indices at least Window steps ahead of their use, keeping them in a small
+ * ring, and prefetch every cache line of their target element when the
+ * index is generated.  data[i-1] walks sequentially downwards, which the
+ * hardware prefetcher already handles.
+ */
+
+template <typename T>
+inline void prefetch_element(const T* p) {
+    // Elements need not be line-aligned, so go from the line the element
+    // starts in to the line its last byte is in.
+    constexpr uintptr_t CACHE_LINE = 64;
+    uintptr_t first = uintptr_t(p) & ~(CACHE_LINE - 1);
+    uintptr_t last = uintptr_t(p) + sizeof(T) - 1;
+    for (uintptr_t line = first; line <= last; line += CACHE_LINE)
+	__builtin_prefetch(reinterpret_cast<const void*>(line), 1);
+}
+
+template <size_t Window, typename IndexT, typename T, typename DrawBatch>
+void prefetch_shuffle_impl(T* data, IndexT n, DrawBatch draw) {
+    static_assert((Window & (Window - 1)) == 0, "Window must be a power of two");
+    static_assert(Window >= MAX_INDEX_BATCH, "Window too small");
+    // The index for range r lives in pending[r % RING]; a batch can
+    // overshoot the window by MAX_INDEX_BATCH - 1 entries.
+    constexpr size_t RING = 2 * Window;
+    IndexT pending[RING];
+    IndexT next = n;	// next range to draw an index for
+
+    for (IndexT i = n; i > 1; --i) {
+	while (next > 1 && i - next < Window) {
+	    IndexT batch[MAX_INDEX_BATCH];
+	    unsigned k = draw(next, batch);
+	    for (unsigned t = 0; t < k; ++t, --next) {
+		prefetch_element(data + batch[t]);
+		pending[next % RING] = batch[t];
+	    }
+	}
+	std::swap(data[i-1], data[pending[i % RING]]);
+    }
+}
+
+template <typename IndexT, typename RngT>
+inline auto single_indices(RngT& rng) {
+    return [&rng](IndexT range, IndexT* out) {
+	out[0] = bounded_index(rng, range);
+	return 1u;
+    };
+}
+
+template <typename IndexT, typename RngT>
+inline auto batched_indices(RngT& rng) {
+    return [&rng](IndexT range, IndexT* out) {
+	return draw_index_batch(rng, range, out);
+    };
+}
+
+template <typename T, typename RngT>
+void fisher_yates_shuffle(T* data, size_t n, RngT& rng) {
+    if (n <= UINT32_MAX)
+	fisher_yates_shuffle_impl(data, uint32_t(n),
+				  single_indices<uint32_t>(rng));
+    else
+	fisher_yates_shuffle_impl(data, uint64_t(n),
+				  single_indices<uint64_t>(rng));
+}
+
+template <size_t Window = 32, typename T, typename RngT>
+void prefetch_shuffle(T* data, size_t n, RngT& rng) {
+    if (n <= UINT32_MAX)
+	prefetch_shuffle_impl<Window>(data, uint32_t(n),
+				      single_indices<uint32_t>(rng));
+    else
+	prefetch_shuffle_impl<Window>(data, uint64_t(n),
+				      single_indices<uint64_t>(rng));
+}
+
+template <typename T, typename RngT>
+void batched_shuffle(T* data, size_t n, RngT& rng) {
+    if (n <= UINT32_MAX)
+	fisher_yates_shuffle_impl(data, uint32_t(n),
+				  batched_indices<uint32_t>(rng));
+    else
+	fisher_yates_shuffle_impl(data, uint64_t(n),
+				  batched_indices<uint64_t>(rng));
+}
+
+template <size_t Window = 32, typename T, typename RngT>
+void batched_prefetch_shuffle(T* data, size_t n, RngT& rng) {
+    if (n <= UINT32_MAX)
+	prefetch_shuffle_impl<Window>(data, uint32_t(n),
+				      batched_indices<uint32_t>(rng));
+    else
+	prefetch_shuffle_impl<Window>(data, uint64_t(n),
+				      batched_indices<uint64_t>(rng));
+}
+
+#endif // SHUFFLE_HPP_INCLUDED
@@ -0,0 +1,32 @@
+#!/usr/bin/perl -lw
+
+# Usage: slowdown.pl baseline.tsv pressured.tsv
+#
+# Divides each time in a summary from summarize.pl by the matching time in
+# a baseline summary, matching rows by everything after the program name
+# (so sweep32.pcg32.debiased_int_mult matches bounded32.pcg32.debiased_int_mult).
+
+use strict;
+
+my ($baseFile, $pressuredFile) = @ARGV;
+@ARGV == 2 or die "Usage: $0 baseline.tsv pressured.tsv\n";
+
+my %baseFor;
+open my $base, "<", $baseFile or die "Can't open '$baseFile' ($!)";
+while (<$base>) {
+    chomp;
+    my ($id, @cols) = split /\t/;
+    $id =~ s{^[^.]*}{};
+    $baseFor{$id} = \@cols;
+}
+
+open my $pressured, "<", $pressuredFile or die "Can't open '$pressuredFile' ($!)";
+while (<$pressured>) {
+    chomp;
+    my ($id, @cols) = split /\t/;
+    my $key = $id;
+    $key =~ s{^[^.]*}{};
+    my $baseCols = $baseFor{$key} or next;
+    next unless @$baseCols == @cols;
+    print join("\t", $id, map { $cols[$_] / $baseCols->[$_] } 0 .. $#cols);
+}
@@ -0,0 +1,181 @@
+/*
+ * A C++ benchmark for seeking in and checkpointing random streams
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2018 Melissa E. O'Neill
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include <iostream>
+#include <sstream>
+#include <cstdint>
+#include <cstdlib>
+#include <cassert>
+#include <random>
+#include <vector>
+#include <string>
+#include "pcg_random.hpp"
+#include "timer.hpp"
+#include "stream.hpp"
+
+#ifdef RNG_INCLUDE
+    #include RNG_INCLUDE
+#endif
+
+#ifndef RNG_TYPE
+    #define RNG_TYPE std::mt19937
+#endif
+
+using rng_t = RNG_TYPE;
+using stream_t = seekable_stream<rng_t>;
+
+// Seeks per distance
+#ifndef STREAM_SEEKS
+    #define STREAM_SEEKS 10000
+#endif
+
+// Seeking by stepping through more outputs than this (in total, for each
+// distance) is skipped.
+#ifndef STREAM_MAX_STEP
+    #define STREAM_MAX_STEP (1ull << 32)
+#endif
+
+/*
+ * Each variant seeks a stream to a raw-output position, either jumping
+ * ahead (in O(log n) time for generators that support it) or stepping
+ * through every output in between, as replaying a job from its seed would.
+ */
+
+#if USE_JUMP
+
+static constexpr bool fast_seek = stream_t::fast_seek;
+
+static void seek(stream_t& stream, uint64_t position) {
+    stream.seek(position);
+}
+
+#elif USE_STEP
+
+static constexpr bool fast_seek = false;
+
+static void seek(stream_t& stream, uint64_t position) {
+    if (position < stream.position())
+	stream.seek(0);
+    stream.discard(position - stream.position());
+}
+
+#endif
+
+/*
+ * Check that seeking gives the same outputs as drawing sequentially, and
+ * that resuming from a checkpoint gives the same bounded values as carrying
+ * on would have.
+ */
+
+static void check(uint64_t seed) {
+    for (uint64_t position : {0, 1, 2, 1000, 123457, 1 << 20}) {
+	stream_t drawn(seed), sought(seed);
+	drawn.discard(position);
+	seek(sought, position);
+	assert(sought.position() == position);
+	for (int i = 0; i < 100; ++i)
+	    assert(drawn() == sought());
+
+	// ... and backwards
+	stream_t redrawn(seed);
+	redrawn.discard(position / 2);
+	seek(sought, position / 2);
+	for (int i = 0; i < 100; ++i)
+	    assert(redrawn() == sought());
+    }
+
+    // Large ranges reject often, so positions depend on the values drawn.
+    const uint64_t ranges[] = { 6, 0x80000001, 52, 0x8000000000000001 };
+    stream_t stream(seed);
+    for (uint64_t i = 0; i < 1000; ++i)
+	stream.bounded(ranges[i % 4]);
+    std::stringstream checkpoint;
+    checkpoint << stream;
+    std::vector<uint64_t> expected;
+    for (uint64_t i = 0; i < 1000; ++i)
+	expected.push_back(stream.bounded(ranges[i % 4]));
+
+    stream_t resumed;
+    checkpoint >> resumed;
+    assert(checkpoint);
+    for (uint64_t i = 0; i < 1000; ++i) {
+	uint64_t value = resumed.bounded(ranges[i % 4]);
+	assert(value == expected[i]);
+	(void) value;
+    }
+    assert(resumed.position() == stream.position());
+    std::cout << "Checks passed\n";
+}
+
+int main(int argc, char* argv[])
+{
+    uint64_t seed;
+    if (argc <= 1) {
+	std::random_device rdev;
+	seed = rdev();
+	seed <<= 32;
+	seed |= rdev();
+    } else {
+	seed = strtoul(argv[1], nullptr, 0);
+    }
+    Timer timer;
+
+    check(seed);
+
+    // Seek distances, given as powers of two (default 2^10 to 2^60)
+    std::vector<int> exponents;
+    for (int i = 2; i < argc; ++i)
+	exponents.push_back(atoi(argv[i]));
+    if (exponents.empty())
+	exponents = {10, 20, 30, 40, 50, 60};
+
+    for (int exponent : exponents) {
+	uint64_t distance = uint64_t(1) << exponent;
+	uint64_t seeks = STREAM_SEEKS;
+	if (!fast_seek) {
+	    if (distance > STREAM_MAX_STEP) {
+		std::cout << "Seek 2^" << exponent << " skipped\n";
+		continue;
+	    }
+	    if (seeks > STREAM_MAX_STEP / distance)
+		seeks = STREAM_MAX_STEP / distance;
+	}
+
+	// Each seek starts from a fresh stream, as when resuming a job.
+	stream_t stream(seed);
+	uint64_t check = 0;
+	std::string what = "Seek 2^" + std::to_string(exponent);
+	timer.start(what.c_str());
+	for (uint64_t i = 0; i < seeks; ++i) {
+	    seek(stream, 0);
+	    seek(stream, distance - 1 - i % (distance / 2));
+	    check += stream();
+	}
+	timer.done(seeks);
+	std::cout << "Check" << exponent << " = " << check << "\n";
+    }
+}
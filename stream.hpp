@@ -0,0 +1,350 @@
+#ifndef STREAM_HPP_INCLUDED
+#define STREAM_HPP_INCLUDED
+
+/*
+ * A C++ implementation of seekable, checkpointable random streams, for
+ * jobs that need to stop and later resume drawing at exactly the same
+ * point without replaying everything they drew before.
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2018 Melissa E. O'Neill
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <cstdint>
+#include <cassert>
+#include <istream>
+#include <ostream>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "bounded.hpp"
+
+/*
+ * Advance a generator by count outputs, as cheaply as it allows: in
+ * O(log count) time for generators with an advance member (PCG, and
+ * xoshiro256starstar64_seekable below), otherwise with discard, or failing
+ * that by drawing and throwing away count outputs.
+ */
+
+template <typename RngT, typename = void>
+struct has_advance : std::false_type {};
+
+template <typename RngT>
+struct has_advance<RngT, std::void_t<decltype(
+    std::declval<RngT&>().advance(uint64_t(0)))>> : std::true_type {};
+
+template <typename RngT, typename = void>
+struct has_discard : std::false_type {};
+
+template <typename RngT>
+struct has_discard<RngT, std::void_t<decltype(
+    std::declval<RngT&>().discard(uint64_t(0)))>> : std::true_type {};
+
+template <typename RngT>
+void jump_ahead(RngT& rng, uint64_t count) {
+    if constexpr (has_advance<RngT>::value) {
+	rng.advance(count);
+    } else if constexpr (has_discard<RngT>::value) {
+	rng.discard(count);
+    } else {
+	for (; count > 0; --count)
+	    rng();
+    }
+}
+
+/*
+ * A seekable_stream wraps a generator made from a seed and counts the raw
+ * outputs drawn from it (including any that a bounded method rejects), so
+ * its whole state is the seed and that position.  It writes and reads
+ * those two numbers as text; reading them back recreates the generator and
+ * jumps ahead to the same position, after which it produces the same
+ * outputs, and so the same bounded values, as the original.
+ */
+
+template <typename RngT>
+class seekable_stream {
+    uint64_t seed_;
+    RngT start_;
+    RngT rng_;
+    uint64_t position_ = 0;
+
+public:
+    using result_type = typename RngT::result_type;
+
+    // Whether seek takes O(log n) time rather than O(n).
+    static constexpr bool fast_seek = has_advance<RngT>::value;
+
+    explicit seekable_stream(uint64_t seed = 0)
+	: seed_(seed), start_(seed), rng_(start_)
+    {
+    }
+
+    static constexpr result_type min() { return RngT::min(); }
+    static constexpr result_type max() { return RngT::max(); }
+
+    result_type operator()() {
+	++position_;
+	return rng_();
+    }
+
+    uint64_t bounded(uint64_t range) {
+	return bounded_rand_any(*this, range);
+    }
+
+    uint64_t seed() const {
+	return seed_;
+    }
+
+    uint64_t position() const {
+	return position_;
+    }
+
+    // Go to the given raw-output position, forwards or backwards.
+    void seek(uint64_t position) {
+	if (position < position_) {
+	    rng_ = start_;
+	    position_ = 0;
+	}
+	if (position == position_)
+	    return;
+	jump_ahead(rng_, position - position_);
+	position_ = position;
+    }
+
+    // Skip count outputs by drawing them, however the generator can seek.
+    void discard(uint64_t count) {
+	for (uint64_t i = 0; i < count; ++i)
+	    rng_();
+	position_ += count;
+    }
+};
+
+template <typename RngT>
+std::ostream& operator<<(std::ostream& out, const seekable_stream<RngT>& stream)
+{
+    return out << stream.seed() << ' ' << stream.position();
+}
+
+template <typename RngT>
+std::istream& operator>>(std::istream& in, seekable_stream<RngT>& stream)
+{
+    uint64_t seed, position;
+    if (in >> seed >> position) {
+	stream = seekable_stream<RngT>(seed);
+	stream.seek(position);
+    }
+    return in;
+}
+
+/*
+ * xoshiro256** (Blackman and Vigna), with an advance member that jumps any
+ * distance n in O(log n) time.  The generator's transition is a linear map
+ * T on 256-bit states over GF(2), so with P its characteristic polynomial
+ * and x^n = r(x) mod P(x), T^n = r(T), a sum of at most 256 powers of T,
+ * which we apply to the state by Horner's rule.  We find P once by running
+ * the Berlekamp-Massey algorithm on 512 bits of the state sequence, and
+ * tabulate x^256 ... x^511 mod P so that squaring mod P is cheap.
+ */
+
+class xoshiro256starstar64_seekable {
+    using state = uint64_t[4];
+
+    state s_;
+
+    static uint64_t rotl(uint64_t x, int k) {
+	return (x << k) | (x >> (64 - k));
+    }
+
+    static void step(state& s) {
+	uint64_t t = s[1] << 17;
+	s[2] ^= s[0];
+	s[3] ^= s[1];
+	s[1] ^= s[2];
+	s[0] ^= s[3];
+	s[2] ^= t;
+	s[3] = rotl(s[3], 45);
+    }
+
+    // Polynomials of degree < 256 over GF(2), the coefficient of x^i in
+    // bit i % 64 of word i / 64.
+    struct poly {
+	uint64_t w[4] = {0, 0, 0, 0};
+
+	bool bit(unsigned i) const {
+	    return (w[i / 64] >> (i % 64)) & 1;
+	}
+    };
+
+    // Coefficients of x^(256+k) mod P for k = 0..255, for reducing
+    // products; reduce[0] is P(x) - x^256.
+    struct reduction_table {
+	poly reduce[256];
+    };
+
+    static const reduction_table& tables() {
+	static const reduction_table table = make_tables();
+	return table;
+    }
+
+    static reduction_table make_tables() {
+	constexpr unsigned N = 256;
+	state s = {1, 2, 3, 4};
+	std::vector<uint8_t> seq(2 * N);
+	for (auto& bit : seq) {
+	    bit = s[0] & 1;
+	    step(s);
+	}
+	// Berlekamp-Massey: c is the shortest recurrence found so far,
+	// c[0] + c[1] x + ... + c[len] x^len.
+	std::vector<uint8_t> c(2 * N + 1), b(2 * N + 1), t;
+	c[0] = b[0] = 1;
+	unsigned len = 0;
+	int m = -1;
+	for (unsigned n = 0; n < 2 * N; ++n) {
+	    uint8_t d = seq[n];
+	    for (unsigned i = 1; i <= len; ++i)
+		d ^= c[i] & seq[n - i];
+	    if (d) {
+		t = c;
+		for (unsigned i = 0; i + n - m <= 2 * N; ++i)
+		    c[i + n - m] ^= b[i];
+		if (2 * len <= n) {
+		    len = n + 1 - len;
+		    m = n;
+		    b = t;
+		}
+	    }
+	}
+	assert(len == N);
+	// P is the reciprocal of c: the coefficient of x^(N-i) is c[i].
+	reduction_table table;
+	for (unsigned j = 0; j < N; ++j)
+	    table.reduce[0].w[j / 64] |= uint64_t(c[N - j]) << (j % 64);
+	for (unsigned k = 1; k < N; ++k)
+	    table.reduce[k] = times_x(table.reduce[k - 1], table.reduce[0]);
+	return table;
+    }
+
+    // a * x mod P, given P's low coefficients
+    static poly times_x(poly a, const poly& low) {
+	uint64_t carry = a.w[3] >> 63;
+	for (unsigned i = 3; i > 0; --i)
+	    a.w[i] = (a.w[i] << 1) | (a.w[i - 1] >> 63);
+	a.w[0] <<= 1;
+	uint64_t mask = -carry;
+	for (unsigned i = 0; i < 4; ++i)
+	    a.w[i] ^= low.w[i] & mask;
+	return a;
+    }
+
+    // Spread the low 32 bits of x out to the even bits
+    static uint64_t spread(uint64_t x) {
+	x &= 0xffffffff;
+	x = (x | (x << 16)) & 0x0000ffff0000ffff;
+	x = (x | (x << 8)) & 0x00ff00ff00ff00ff;
+	x = (x | (x << 4)) & 0x0f0f0f0f0f0f0f0f;
+	x = (x | (x << 2)) & 0x3333333333333333;
+	x = (x | (x << 1)) & 0x5555555555555555;
+	return x;
+    }
+
+    // a^2 mod P; over GF(2), squaring just spreads out the coefficients.
+    static poly square(const poly& a, const reduction_table& table) {
+	uint64_t product[8];
+	for (unsigned i = 0; i < 4; ++i) {
+	    product[2 * i] = spread(a.w[i]);
+	    product[2 * i + 1] = spread(a.w[i] >> 32);
+	}
+	poly r;
+	for (unsigned i = 0; i < 4; ++i)
+	    r.w[i] = product[i];
+	for (unsigned i = 0; i < 4; ++i) {
+	    for (uint64_t high = product[4 + i]; high != 0; high &= high - 1) {
+		const poly& term = table.reduce[64 * i + __builtin_ctzll(high)];
+		for (unsigned j = 0; j < 4; ++j)
+		    r.w[j] ^= term.w[j];
+	    }
+	}
+	return r;
+    }
+
+public:
+    using result_type = uint64_t;
+
+    explicit xoshiro256starstar64_seekable(uint64_t seed = 0) {
+	// Fill the state with SplitMix64, as the xoshiro authors suggest.
+	for (auto& word : s_) {
+	    uint64_t z = (seed += 0x9e3779b97f4a7c15);
+	    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+	    z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+	    word = z ^ (z >> 31);
+	}
+    }
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return UINT64_MAX; }
+
+    result_type operator()() {
+	uint64_t result = rotl(s_[1] * 5, 7) * 9;
+	step(s_);
+	return result;
+    }
+
+    void advance(uint64_t count) {
+	if (count == 0)
+	    return;
+	// r = x^count mod P, by left-to-right binary exponentiation from
+	// the top set bit of count
+	const reduction_table& table = tables();
+	poly r;
+	r.w[0] = 1;
+	for (unsigned i = 64 - __builtin_clzll(count); i-- > 0; ) {
+	    r = square(r, table);
+	    if ((count >> i) & 1)
+		r = times_x(r, table.reduce[0]);
+	}
+	// Horner's rule: s = r(T) s
+	state acc = {0, 0, 0, 0};
+	for (unsigned i = 256; i-- > 0; ) {
+	    step(acc);
+	    if (r.bit(i)) {
+		for (unsigned j = 0; j < 4; ++j)
+		    acc[j] ^= s_[j];
+	    }
+	}
+	for (unsigned j = 0; j < 4; ++j)
+	    s_[j] = acc[j];
+    }
+
+    void discard(uint64_t count) {
+	advance(count);
+    }
+
+    bool operator==(const xoshiro256starstar64_seekable& other) const {
+	for (unsigned j = 0; j < 4; ++j)
+	    if (s_[j] != other.s_[j])
+		return false;
+	return true;
+    }
+};
+
+#endif // STREAM_HPP_INCLUDED
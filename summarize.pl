@@ -8,11 +8,15 @@ my $byPRNG;
 my $byMethod;
 my $byCompiler;
 my $bySeed;
+my $byBits;
+my $byBitsCalls;
 
 GetOptions ("method"   => \$byMethod,
 	    "prng"     => \$byPRNG,
             "compiler" => \$byCompiler,
-            "seed"     => \$bySeed)
+            "seed"     => \$bySeed,
+            "bits"     => \$byBits,
+            "bits-calls" => \$byBitsCalls)
     or die("Error in command line arguments\n");
 
 
@@ -26,14 +30,22 @@ foreach my $file (@ARGV) {
     open my $fh, "<", $file or die "Can't open '$file' ($!)"; 
     while (<$fh>) { 
 	chomp; 
-	next unless m{^(.*?) completed \((\S+) seconds\)}; 
+	# With --bits, the columns are Test 3's per-bit-width timings instead,
+	# and with --bits-calls, its generator outputs used per call (only
+	# printed by builds with RNG_HAS_DISTANCE)
+	my $pattern = $byBitsCalls ? qr{^Test 3 bits (\d+): .*\((\S+) per call\)}
+		    : $byBits      ? qr{^Test 3 bits (\d+): (\S+) seconds}
+		    :                qr{^(.*?) completed \((\S+) seconds\)};
+	next unless m{$pattern}; 
 	push @{$timeFor{$id}{$1}}, $2; 
     }
 }
 
 foreach my $id (sort keys %timeFor) { 
     my @cols;
-    foreach my $kind (sort keys %{$timeFor{$id}}) { 
+    my @kinds = sort keys %{$timeFor{$id}};
+    @kinds = sort { $a <=> $b } @kinds if $byBits || $byBitsCalls;
+    foreach my $kind (@kinds) { 
 	my $sum = 0;
 	$sum += log $_ foreach @{$timeFor{$id}{$kind}}; 
 	my $avg = $sum/@{$timeFor{$id}{$kind}}; 
@@ -28,6 +28,7 @@
  */
 
 #include <chrono>
+#include <cstdint>
 #include <iostream>
 
 struct Timer
@@ -35,6 +36,11 @@ struct Timer
     std::chrono::time_point<std::chrono::system_clock> start_;
     const char* what_ = nullptr;
 
+    // Optionally, a running total of time (in seconds) that the timings
+    // should leave out, such as time spent in cache_pressure's sweeps.
+    double (*excluded_)() = nullptr;
+    double excluded_start_ = 0;
+
     Timer() = default;
 
     Timer(const char* what)
@@ -45,14 +51,31 @@ struct Timer
     void start(const char* what) {
 	what_ = what;
 	std::cout << what_ << " started...\n";
+	if (excluded_)
+	    excluded_start_ = excluded_();
 	start_ = std::chrono::system_clock::now();
     }
 
-    void done() {
+    void exclude(double (*excluded)()) {
+	excluded_ = excluded;
+    }
+
+    double done() {
 	auto end = std::chrono::system_clock::now();
 	std::chrono::duration<double> elapsed_seconds = end-start_;
+	if (excluded_)
+	    elapsed_seconds -= std::chrono::duration<double>(
+				   excluded_() - excluded_start_);
 	std::cout << what_ << " completed (" << elapsed_seconds.count()
 		  << " seconds)\n";
+	return elapsed_seconds.count();
+    }
+
+    // Also report the time per operation, for tests doing count of them.
+    void done(uint64_t count) {
+	double seconds = done();
+	std::cout << what_ << ": " << seconds * 1e9 / count
+		  << " ns per call\n";
     }
 };
 
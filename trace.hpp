@@ -0,0 +1,106 @@
+#ifndef TRACE_HPP_INCLUDED
+#define TRACE_HPP_INCLUDED
+
+/*
+ * A C++ implementation of read-only, memory-mapped traces of recorded
+ * ranges, for replaying real workloads through the bounded-rand methods.
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2018 Melissa E. O'Neill
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <stdexcept>
+#include <system_error>
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/*
+ * A trace file is just an array of ranges, each a native-endian UIntType
+ * (uint32_t for bounded32, uint64_t for bounded64), with no header.  We map
+ * it rather than read it, so replaying iterates over the page cache
+ * directly, and traces larger than memory still work.
+ */
+
+template <typename UIntType>
+class mapped_trace {
+    const UIntType* data_ = nullptr;
+    size_t size_ = 0;
+
+    static std::system_error error(int err, const char* path) {
+	return std::system_error(err, std::generic_category(), path);
+    }
+
+public:
+    explicit mapped_trace(const char* path) {
+	int fd = open(path, O_RDONLY);
+	if (fd < 0)
+	    throw error(errno, path);
+	struct stat info;
+	if (fstat(fd, &info) != 0) {
+	    int err = errno;
+	    close(fd);
+	    throw error(err, path);
+	}
+	size_t bytes = info.st_size;
+	if (bytes == 0 || bytes % sizeof(UIntType) != 0) {
+	    close(fd);
+	    throw std::runtime_error(std::string(path) + ": not a trace of "
+				     + std::to_string(sizeof(UIntType) * 8)
+				     + "-bit ranges");
+	}
+	void* base = mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+	int err = errno;
+	close(fd);
+	if (base == MAP_FAILED)
+	    throw error(err, path);
+	madvise(base, bytes, MADV_WILLNEED);
+	data_ = static_cast<const UIntType*>(base);
+	size_ = bytes / sizeof(UIntType);
+    }
+
+    mapped_trace(const mapped_trace&) = delete;
+    mapped_trace& operator=(const mapped_trace&) = delete;
+
+    ~mapped_trace() {
+	munmap(const_cast<UIntType*>(data_), size_ * sizeof(UIntType));
+    }
+
+    size_t size() const {
+	return size_;
+    }
+
+    const UIntType* begin() const {
+	return data_;
+    }
+
+    const UIntType* end() const {
+	return data_ + size_;
+    }
+};
+
+#endif // TRACE_HPP_INCLUDED